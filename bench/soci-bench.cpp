@@ -0,0 +1,733 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Benchmarks measuring the overhead of the most common SOCI operations.
+//
+// The benchmarks use only the backends which don't need any database server,
+// i.e. the empty backend, generating synthetic results, and SQLite in-memory
+// database, so that they can be run anywhere and their results compared
+// between the different SOCI versions. The results are output in JSON (by
+// default) or CSV format.
+
+#include "soci/soci.h"
+#include "soci/version.h"
+
+#ifdef SOCI_BENCH_HAVE_EMPTY
+#include "soci/empty/soci-empty.h"
+#endif
+
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+#include "soci/sqlite3/soci-sqlite3.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace soci;
+
+namespace // anonymous
+{
+
+// Number of rows in the table used by the benchmarks.
+int const table_rows = 1000;
+
+// Number of rows inserted or fetched at once by the bulk operations.
+int const bulk_size = 100;
+
+// Number of sessions in the pool used by the pool benchmark.
+std::size_t const pool_size = 4;
+
+struct bench_record
+{
+    int id;
+    std::string name;
+    double value;
+};
+
+} // namespace anonymous
+
+namespace soci
+{
+
+template <>
+struct type_conversion<bench_record>
+{
+    typedef values base_type;
+
+    static void from_base(values const & v, indicator /* ind */,
+        bench_record & r)
+    {
+        // Use positions rather than names because the empty backend names
+        // its columns differently from the real table.
+        r.id = v.get<int>(0);
+        r.name = v.get<std::string>(1);
+        r.value = v.get<double>(2);
+    }
+
+    static void to_base(bench_record const & r, values & v, indicator & ind)
+    {
+        v.set("id", r.id);
+        v.set("name", r.name);
+        v.set("value", r.value);
+        ind = i_ok;
+    }
+};
+
+} // namespace soci
+
+namespace // anonymous
+{
+
+// Data shared by all benchmarks for the given backend.
+struct bench_context
+{
+    bench_context(backend_factory const & factory,
+            std::string const & connectString)
+        : factory_(factory), connectString_(connectString),
+          sql_(factory, connectString)
+    {
+    }
+
+    void start_timer() { start_ = std::chrono::steady_clock::now(); }
+    void stop_timer() { stop_ = std::chrono::steady_clock::now(); }
+
+    long long get_elapsed_ns() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            stop_ - start_).count();
+    }
+
+    backend_factory const & factory_;
+    std::string const connectString_;
+    session sql_;
+
+private:
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point stop_;
+};
+
+// Each benchmark function runs the given number of iterations of its
+// scenario between start_timer() and stop_timer() calls and returns the
+// total number of rows processed.
+typedef long long (*bench_function)(bench_context & ctx, int iterations);
+
+long long bench_select_one(bench_context & ctx, int iterations)
+{
+    int id = 0;
+    std::string name;
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        id = i % table_rows + 1;
+        ctx.sql_ << "select name from soci_bench where id = :id",
+            into(name), use(id);
+    }
+    ctx.stop_timer();
+
+    return iterations;
+}
+
+long long bench_select_one_prepared(bench_context & ctx, int iterations)
+{
+    int id = 0;
+    std::string name;
+
+    statement st = (ctx.sql_.prepare <<
+        "select name from soci_bench where id = :id", into(name), use(id));
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        id = i % table_rows + 1;
+        st.execute(true);
+    }
+    ctx.stop_timer();
+
+    return iterations;
+}
+
+long long bench_select_one_typed(bench_context & ctx, int iterations)
+{
+    // All columns are selected here because the empty backend always returns
+    // all of them and the typed statement checks their number.
+    typedef std::tuple<int, std::string, double> bench_row;
+    typed_statement<bench_row, std::tuple<int> > st(ctx.sql_,
+        "select id, name, value from soci_bench where id = :id");
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        st.execute(i % table_rows + 1);
+    }
+    ctx.stop_timer();
+
+    return iterations;
+}
+
+long long bench_bulk_insert(bench_context & ctx, int iterations)
+{
+    std::vector<int> ids(bulk_size);
+    std::vector<std::string> names(bulk_size);
+    std::vector<double> values(bulk_size);
+    for (int i = 0; i != bulk_size; ++i)
+    {
+        ids[i] = i;
+        names[i] = "inserted";
+        values[i] = i + 0.5;
+    }
+
+    statement st = (ctx.sql_.prepare <<
+        "insert into soci_bench_insert(id, name, value)"
+        " values(:id, :name, :value)",
+        use(ids), use(names), use(values));
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        st.execute(true);
+    }
+    ctx.stop_timer();
+
+    ctx.sql_ << "delete from soci_bench_insert";
+
+    return static_cast<long long>(iterations) * bulk_size;
+}
+
+long long bench_bulk_select(bench_context & ctx, int iterations)
+{
+    std::vector<int> ids(bulk_size);
+    std::vector<std::string> names(bulk_size);
+    std::vector<double> values(bulk_size);
+
+    statement st = (ctx.sql_.prepare <<
+        "select id, name, value from soci_bench",
+        into(ids), into(names), into(values));
+
+    long long rows = 0;
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        ids.resize(bulk_size);
+        names.resize(bulk_size);
+        values.resize(bulk_size);
+
+        st.execute();
+        while (st.fetch())
+        {
+            rows += ids.size();
+        }
+    }
+    ctx.stop_timer();
+
+    return rows;
+}
+
+long long bench_rowset_row(bench_context & ctx, int iterations)
+{
+    long long rows = 0;
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        rowset<row> rs = (ctx.sql_.prepare <<
+            "select id, name, value from soci_bench");
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            row const & r = *it;
+            if (r.get<int>(0) < 0 || r.get<std::string>(1).empty() ||
+                    r.get<double>(2) < 0)
+            {
+                throw soci_error("Unexpected value in rowset<row> benchmark.");
+            }
+
+            ++rows;
+        }
+    }
+    ctx.stop_timer();
+
+    return rows;
+}
+
+long long bench_type_conversion(bench_context & ctx, int iterations)
+{
+    long long rows = 0;
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        rowset<bench_record> rs = (ctx.sql_.prepare <<
+            "select id, name, value from soci_bench");
+        for (rowset<bench_record>::const_iterator it = rs.begin();
+             it != rs.end();
+             ++it)
+        {
+            if (it->id < 0)
+            {
+                throw soci_error("Unexpected value in type_conversion benchmark.");
+            }
+
+            ++rows;
+        }
+    }
+    ctx.stop_timer();
+
+    return rows;
+}
+
+long long bench_pool_lease(bench_context & ctx, int iterations)
+{
+    connection_pool pool(pool_size);
+    for (std::size_t i = 0; i != pool_size; ++i)
+    {
+        pool.at(i).open(ctx.factory_, ctx.connectString_);
+    }
+
+    ctx.start_timer();
+    for (int i = 0; i != iterations; ++i)
+    {
+        session sql(pool);
+    }
+    ctx.stop_timer();
+
+    return 0;
+}
+
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+
+// Name of the database file used by the SQLite benchmarks below.
+char const * const sqlite3_bench_file = "soci_bench_copy.db";
+
+// Save the benchmark database to a file and run the given number of
+// iterations opening it, either directly or as an in-memory copy, or
+// querying it, depending on the parameters.
+long long bench_sqlite3_copy(bench_context & ctx, int iterations,
+    bool inMemory, bool open)
+{
+    std::remove(sqlite3_bench_file);
+    static_cast<sqlite3_session_backend *>(ctx.sql_.get_backend())
+        ->save_to(sqlite3_bench_file);
+
+    std::string connectString("db=");
+    connectString += sqlite3_bench_file;
+
+    // Don't copy the pages freed by the other scenarios.
+    session(ctx.factory_, connectString) << "vacuum";
+    if (inMemory)
+    {
+        connectString += " in_memory=true";
+    }
+
+    int count = 0;
+    if (open)
+    {
+        ctx.start_timer();
+        for (int i = 0; i != iterations; ++i)
+        {
+            session sql(ctx.factory_, connectString);
+
+            // Force reading the schema to make the comparison fair.
+            sql << "select count(*) from soci_bench", into(count);
+        }
+        ctx.stop_timer();
+    }
+    else
+    {
+        session sql(ctx.factory_, connectString);
+
+        int id = 0;
+        std::string name;
+        statement st = (sql.prepare <<
+            "select name from soci_bench where id = :id", into(name), use(id));
+
+        ctx.start_timer();
+        for (int i = 0; i != iterations; ++i)
+        {
+            id = i % table_rows + 1;
+            st.execute(true);
+        }
+        ctx.stop_timer();
+    }
+
+    std::remove(sqlite3_bench_file);
+
+    return open ? static_cast<long long>(iterations) * count : iterations;
+}
+
+long long bench_sqlite3_open_file(bench_context & ctx, int iterations)
+{
+    return bench_sqlite3_copy(ctx, iterations, false, true);
+}
+
+long long bench_sqlite3_open_in_memory(bench_context & ctx, int iterations)
+{
+    return bench_sqlite3_copy(ctx, iterations, true, true);
+}
+
+long long bench_sqlite3_select_file(bench_context & ctx, int iterations)
+{
+    return bench_sqlite3_copy(ctx, iterations, false, false);
+}
+
+long long bench_sqlite3_select_in_memory(bench_context & ctx, int iterations)
+{
+    return bench_sqlite3_copy(ctx, iterations, true, false);
+}
+
+#endif // SOCI_BENCH_HAVE_SQLITE3
+
+struct bench_scenario
+{
+    char const * name;
+    int iterations;
+    bench_function func;
+
+    // The only backend this scenario can be used with or NULL if it can be
+    // used with all of them.
+    char const * backend;
+};
+
+// The number of iterations is chosen to make each scenario take roughly the
+// same time when using the empty backend. The SQLite-specific scenarios
+// compare using the database file with using its in-memory copy.
+bench_scenario const scenarios[] =
+{
+    { "select_one",                 20000, bench_select_one, NULL },
+    { "select_one_prepared",        50000, bench_select_one_prepared, NULL },
+    { "select_one_typed",           50000, bench_select_one_typed, NULL },
+    { "bulk_insert",                 2000, bench_bulk_insert, NULL },
+    { "bulk_select",                  200, bench_bulk_select, NULL },
+    { "rowset_row",                   100, bench_rowset_row, NULL },
+    { "type_conversion",              100, bench_type_conversion, NULL },
+    { "pool_lease",                100000, bench_pool_lease, NULL },
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+    { "sqlite3_open_file",            200, bench_sqlite3_open_file, "sqlite3" },
+    { "sqlite3_open_in_memory",       200, bench_sqlite3_open_in_memory, "sqlite3" },
+    { "sqlite3_select_file",        50000, bench_sqlite3_select_file, "sqlite3" },
+    { "sqlite3_select_in_memory",   50000, bench_sqlite3_select_in_memory, "sqlite3" },
+#endif
+};
+
+struct bench_backend
+{
+    std::string name;
+    backend_factory const * factory;
+    std::string connectString;
+};
+
+struct bench_result
+{
+    std::string backend;
+    std::string scenario;
+    int iterations;
+    long long rows;
+
+    // Minimal and median time over all repetitions.
+    long long minNs;
+    long long medianNs;
+};
+
+enum output_format
+{
+    format_json,
+    format_csv
+};
+
+bool get_backend(std::string const & name, bench_backend & backend)
+{
+    backend.name = name;
+
+#ifdef SOCI_BENCH_HAVE_EMPTY
+    if (name == "empty")
+    {
+        backend.factory = factory_empty();
+
+        std::ostringstream ss;
+        ss << "rows=" << table_rows << " columns=int,string,double";
+        backend.connectString = ss.str();
+        return true;
+    }
+#endif
+
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+    if (name == "sqlite3")
+    {
+        backend.factory = factory_sqlite3();
+        backend.connectString = "db=:memory:";
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+// Create and fill the tables used by the benchmarks.
+void create_tables(session & sql)
+{
+    sql << "create table soci_bench(id integer, name varchar(20), value float)";
+    sql << "create table soci_bench_insert(id integer, name varchar(20), value float)";
+
+    std::vector<int> ids(table_rows);
+    std::vector<std::string> names(table_rows);
+    std::vector<double> values(table_rows);
+    for (int i = 0; i != table_rows; ++i)
+    {
+        ids[i] = i + 1;
+
+        std::ostringstream ss;
+        ss << "name_" << i + 1;
+        names[i] = ss.str();
+
+        values[i] = i + 1.5;
+    }
+
+    transaction tr(sql);
+    sql << "insert into soci_bench(id, name, value) values(:id, :name, :value)",
+        use(ids), use(names), use(values);
+    tr.commit();
+}
+
+void run_backend(bench_backend const & backend, int scale, int repeat,
+    std::string const & filter, std::vector<bench_result> & results)
+{
+    bench_context ctx(*backend.factory, backend.connectString);
+
+    create_tables(ctx.sql_);
+
+    for (std::size_t n = 0; n != sizeof(scenarios) / sizeof(scenarios[0]); ++n)
+    {
+        bench_scenario const & scenario = scenarios[n];
+        if (!filter.empty() && filter != scenario.name)
+        {
+            continue;
+        }
+
+        if (scenario.backend && backend.name != scenario.backend)
+        {
+            continue;
+        }
+
+        bench_result result;
+        result.backend = backend.name;
+        result.scenario = scenario.name;
+        result.iterations = scenario.iterations * scale;
+
+        // Warm up the caches and allocate everything that is allocated only
+        // once before measuring anything.
+        scenario.func(ctx, 1);
+
+        std::vector<long long> times;
+        for (int i = 0; i != repeat; ++i)
+        {
+            result.rows = scenario.func(ctx, result.iterations);
+            times.push_back(ctx.get_elapsed_ns());
+        }
+
+        std::sort(times.begin(), times.end());
+        result.minNs = times.front();
+        result.medianNs = times[times.size() / 2];
+
+        results.push_back(result);
+    }
+}
+
+void output_results(std::vector<bench_result> const & results,
+    output_format format, int repeat)
+{
+    std::ostream & os = std::cout;
+
+    switch (format)
+    {
+        case format_json:
+            os << "{\n"
+               << "  \"soci_version\": \"" << SOCI_LIB_VERSION << "\",\n"
+               << "  \"repeat\": " << repeat << ",\n"
+               << "  \"results\": [";
+            for (std::size_t n = 0; n != results.size(); ++n)
+            {
+                bench_result const & r = results[n];
+                os << (n ? "," : "") << "\n"
+                   << "    { \"backend\": \"" << r.backend << "\""
+                   << ", \"scenario\": \"" << r.scenario << "\""
+                   << ", \"iterations\": " << r.iterations
+                   << ", \"rows\": " << r.rows
+                   << ", \"min_ns\": " << r.minNs
+                   << ", \"median_ns\": " << r.medianNs
+                   << ", \"ns_per_iteration\": " << r.minNs / r.iterations
+                   << " }";
+            }
+            os << "\n  ]\n}\n";
+            break;
+
+        case format_csv:
+            os << "backend,scenario,iterations,rows,min_ns,median_ns,ns_per_iteration\n";
+            for (std::size_t n = 0; n != results.size(); ++n)
+            {
+                bench_result const & r = results[n];
+                os << r.backend << ","
+                   << r.scenario << ","
+                   << r.iterations << ","
+                   << r.rows << ","
+                   << r.minNs << ","
+                   << r.medianNs << ","
+                   << r.minNs / r.iterations << "\n";
+            }
+            break;
+    }
+}
+
+void usage(char const * progname)
+{
+    std::cerr << "usage: " << progname
+              << " [--format=json|csv] [--scale=N] [--repeat=N]"
+                 " [--scenario=NAME] [backend[=connection-string]...]\n"
+              << "\n"
+              << "Available backends:"
+#ifdef SOCI_BENCH_HAVE_EMPTY
+              << " empty"
+#endif
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+              << " sqlite3"
+#endif
+              << "\n"
+              << "Available scenarios:";
+    for (std::size_t n = 0; n != sizeof(scenarios) / sizeof(scenarios[0]); ++n)
+    {
+        std::cerr << " " << scenarios[n].name;
+    }
+    std::cerr << "\n";
+}
+
+// Return true if the argument starts with the given option and store the
+// rest of it in the output parameter.
+bool get_option(char const * arg, char const * option, std::string & value)
+{
+    std::size_t const len = std::strlen(option);
+    if (std::strncmp(arg, option, len) != 0)
+    {
+        return false;
+    }
+
+    value = arg + len;
+    return true;
+}
+
+} // namespace anonymous
+
+int main(int argc, char ** argv)
+{
+    output_format format = format_json;
+    int scale = 1;
+    int repeat = 3;
+    std::string filter;
+    std::vector<bench_backend> backends;
+
+    for (int i = 1; i != argc; ++i)
+    {
+        std::string value;
+        if (get_option(argv[i], "--format=", value))
+        {
+            if (value == "json")
+            {
+                format = format_json;
+            }
+            else if (value == "csv")
+            {
+                format = format_csv;
+            }
+            else
+            {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (get_option(argv[i], "--scale=", value))
+        {
+            scale = std::atoi(value.c_str());
+        }
+        else if (get_option(argv[i], "--repeat=", value))
+        {
+            repeat = std::atoi(value.c_str());
+        }
+        else if (get_option(argv[i], "--scenario=", value))
+        {
+            filter = value;
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return std::strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS
+                                                       : EXIT_FAILURE;
+        }
+        else
+        {
+            std::string const arg(argv[i]);
+            std::string::size_type const pos = arg.find('=');
+
+            bench_backend backend;
+            if (!get_backend(arg.substr(0, pos), backend))
+            {
+                std::cerr << "Unknown backend \"" << arg.substr(0, pos) << "\"\n";
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+
+            if (pos != std::string::npos)
+            {
+                backend.connectString = arg.substr(pos + 1);
+            }
+
+            backends.push_back(backend);
+        }
+    }
+
+    if (scale <= 0 || repeat <= 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (backends.empty())
+    {
+        char const * const allBackends[] = { "empty", "sqlite3" };
+        for (std::size_t n = 0; n != 2; ++n)
+        {
+            bench_backend backend;
+            if (get_backend(allBackends[n], backend))
+            {
+                backends.push_back(backend);
+            }
+        }
+    }
+
+    std::vector<bench_result> results;
+
+    try
+    {
+        for (std::size_t n = 0; n != backends.size(); ++n)
+        {
+            run_backend(backends[n], scale, repeat, filter, results);
+        }
+    }
+    catch (std::exception const & e)
+    {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    output_results(results, format, repeat);
+
+    return EXIT_SUCCESS;
+}
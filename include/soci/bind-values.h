@@ -2,6 +2,7 @@
 #define SOCI_BIND_VALUES_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "exchange-arena.h"
 #include "exchange-traits.h"
 #include "into-type.h"
 #include "into.h"
@@ -31,6 +32,8 @@ namespace details
 class use_type_vector: public std::vector<use_type_base *>
 {
 public:
+    use_type_vector() : arena_(NULL) {}
+
     ~use_type_vector()
     {
         for(iterator iter = begin(), _end = end();
@@ -40,9 +43,14 @@ public:
 
     void exchange(use_type_ptr const& u) { push_back(u.get()); u.release(); }
 
+    // Allocate the elements created by exchange() from the given arena.
+    void set_arena(exchange_arena * arena) { arena_ = arena; }
+
     template <typename T, typename Indicator>
     void exchange(use_container<T, Indicator> const &uc)
     {
+        exchange_arena_scope scope(arena_);
+
 #ifdef SOCI_HAVE_BOOST
         exchange_(uc, (typename boost::fusion::traits::is_sequence<T>::type *)NULL);
 #else
@@ -51,6 +59,8 @@ public:
     }
 
 private:
+    exchange_arena * arena_;
+
 #ifdef SOCI_HAVE_BOOST
     template <typename T, typename Indicator>
     struct use_sequence
@@ -127,6 +137,8 @@ private:
 class into_type_vector: public std::vector<details::into_type_base *>
 {
 public:
+    into_type_vector() : arena_(NULL) {}
+
     ~into_type_vector()
     {
         for(iterator iter = begin(), _end = end();
@@ -136,9 +148,14 @@ public:
 
     void exchange(into_type_ptr const& i) { push_back(i.get()); i.release(); }
 
+    // Allocate the elements created by exchange() from the given arena.
+    void set_arena(exchange_arena * arena) { arena_ = arena; }
+
     template <typename T, typename Indicator>
     void exchange(into_container<T, Indicator> const &ic)
     {
+        exchange_arena_scope scope(arena_);
+
 #ifdef SOCI_HAVE_BOOST
         exchange_(ic, (typename boost::fusion::traits::is_sequence<T>::type *)NULL);
 #else
@@ -147,6 +164,8 @@ public:
     }
 
 private:
+    exchange_arena * arena_;
+
 #ifdef SOCI_HAVE_BOOST
     template <typename T, typename Indicator>
     struct into_sequence
@@ -205,6 +205,8 @@ struct SOCI_DB2_DECL db2_statement_backend : details::statement_backend
     db2_vector_into_type_backend* make_vector_into_type_backend() override;
     db2_vector_use_type_backend* make_vector_use_type_backend() override;
 
+    int get_exchange_hooks() const override { return 0; }
+
     db2_session_backend& session_;
 
     SQLHANDLE hStmt;
@@ -20,16 +20,46 @@
 
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace soci
 {
 
+// The empty backend doesn't connect to any database, but it can be configured
+// to produce synthetic results, allowing to measure the overhead of SOCI
+// itself. This is done using the following options in the connection string:
+//
+//  - rows: number of rows returned by every query (by default no data is
+//    returned at all, but all fetches pretend to succeed).
+//  - columns: comma-separated list of the types of the columns returned when
+//    describing the query, e.g. "int,string,double,date".
+//  - string_length: length of the generated strings.
+//  - null_ratio: fraction of the values which are null, from 0 to 1.
+//  - latency_us: delay in microseconds added to every execute and fetch.
+struct empty_session_options
+{
+    empty_session_options()
+        : rows_(-1), stringLength_(10), nullRatio_(0), latencyMicroseconds_(0)
+    {}
+
+    // Parse the options from the connection string, throws on error.
+    void parse(std::string const& connectString);
+
+    bool generates_data() const { return rows_ >= 0; }
+
+    int rows_;
+    std::vector<data_type> columns_;
+    std::size_t stringLength_;
+    double nullRatio_;
+    long latencyMicroseconds_;
+};
+
 struct empty_statement_backend;
 
 struct SOCI_EMPTY_DECL empty_standard_into_type_backend : details::standard_into_type_backend
 {
     empty_standard_into_type_backend(empty_statement_backend &st)
-        : statement_(st)
+        : statement_(st), data_(NULL), type_(), position_(0)
     {}
 
     void define_by_pos(int& position, void* data, details::exchange_type type) override;
@@ -40,12 +70,16 @@ struct SOCI_EMPTY_DECL empty_standard_into_type_backend : details::standard_into
     void clean_up() override;
 
     empty_statement_backend& statement_;
+
+    void* data_;
+    details::exchange_type type_;
+    int position_;
 };
 
 struct SOCI_EMPTY_DECL empty_vector_into_type_backend : details::vector_into_type_backend
 {
     empty_vector_into_type_backend(empty_statement_backend &st)
-        : statement_(st)
+        : statement_(st), data_(NULL), type_(), position_(0)
     {}
 
     void define_by_pos(int& position, void* data, details::exchange_type type) override;
@@ -59,6 +93,10 @@ struct SOCI_EMPTY_DECL empty_vector_into_type_backend : details::vector_into_typ
     void clean_up() override;
 
     empty_statement_backend& statement_;
+
+    void* data_;
+    details::exchange_type type_;
+    int position_;
 };
 
 struct SOCI_EMPTY_DECL empty_standard_use_type_backend : details::standard_use_type_backend
@@ -81,7 +119,7 @@ struct SOCI_EMPTY_DECL empty_standard_use_type_backend : details::standard_use_t
 struct SOCI_EMPTY_DECL empty_vector_use_type_backend : details::vector_use_type_backend
 {
     empty_vector_use_type_backend(empty_statement_backend &st)
-        : statement_(st) {}
+        : statement_(st), data_(NULL), type_() {}
 
     void bind_by_pos(int& position, void* data, details::exchange_type type) override;
     void bind_by_name(std::string const& name, void* data, details::exchange_type type) override;
@@ -93,6 +131,9 @@ struct SOCI_EMPTY_DECL empty_vector_use_type_backend : details::vector_use_type_
     void clean_up() override;
 
     empty_statement_backend& statement_;
+
+    void* data_;
+    details::exchange_type type_;
 };
 
 struct empty_session_backend;
@@ -121,7 +162,32 @@ struct SOCI_EMPTY_DECL empty_statement_backend : details::statement_backend
     empty_vector_into_type_backend* make_vector_into_type_backend() override;
     empty_vector_use_type_backend* make_vector_use_type_backend() override;
 
+    int get_exchange_hooks() const override { return 0; }
+
+    // Return true if the value in the given (0-based) row and column is null.
+    bool is_null_value(int row, int column) const;
+
+    // Store the synthetic value for the given row and column in the variable
+    // of the given type, which may be a vector, in which case the value is
+    // stored in its element with the given index.
+    void generate_value(int row, int column,
+                        details::exchange_type type, void* data) const;
+    void generate_vector_value(int row, int column,
+                               details::exchange_type type, void* data,
+                               std::size_t index) const;
+
     empty_session_backend& session_;
+
+    // The next row to be returned and the rows returned by the last call to
+    // execute() or fetch(), only used when generating data.
+    int nextRow_;
+    int firstRowInBatch_;
+    int rowsInBatch_;
+
+    long long affectedRows_;
+
+private:
+    exec_fetch_result load_rows(int number);
 };
 
 struct empty_rowid_backend : details::rowid_backend
@@ -170,6 +236,14 @@ struct empty_session_backend : details::session_backend
     empty_statement_backend* make_statement_backend() override;
     empty_rowid_backend* make_rowid_backend() override;
     empty_blob_backend* make_blob_backend() override;
+
+    // Wait for the configured latency, if any.
+    void simulate_latency() const;
+
+    empty_session_options options_;
+
+    // The value used for all generated strings.
+    std::string stringValue_;
 };
 
 struct SOCI_EMPTY_DECL empty_backend_factory : backend_factory
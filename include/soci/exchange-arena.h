@@ -0,0 +1,92 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_EXCHANGE_ARENA_H_INCLUDED
+#define SOCI_EXCHANGE_ARENA_H_INCLUDED
+
+#include "soci/soci-platform.h"
+// std
+#include <cstddef>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Memory arena used for allocating the into and use elements of a statement.
+//
+// The first elements are allocated from a buffer inside the arena object
+// itself and only the elements which don't fit into it are allocated from
+// the heap, in bigger chunks. All the memory becomes available again when all
+// the elements allocated from the arena are destroyed, so that a statement
+// executed with the same elements many times doesn't allocate anything after
+// the first time.
+//
+// The arena is not used directly, but through operator new of into_type_base
+// and use_type_base, which use the arena made current by
+// exchange_arena_scope, if any, and the heap otherwise.
+class SOCI_DECL exchange_arena
+{
+public:
+    exchange_arena();
+    ~exchange_arena();
+
+    // Allocate memory for an element using the current arena, if any.
+    static void * allocate_object(std::size_t size);
+
+    // Free memory allocated by allocate_object().
+    static void deallocate_object(void * p);
+
+    // Return the number of elements currently allocated from this arena.
+    std::size_t get_objects_count() const { return objects_; }
+
+    // Return the number of chunks allocated from the heap by this arena.
+    std::size_t get_heap_chunks_count() const;
+
+private:
+    struct chunk;
+
+    void * allocate(std::size_t size);
+    void release();
+
+    // This is big enough for a dozen of simple elements.
+    static std::size_t const buffer_size = 768;
+
+    alignas(std::max_align_t) char buffer_[buffer_size];
+
+    // The chunk currently used for allocations, if not using buffer_, and the
+    // list of all heap chunks, which are reused after release().
+    chunk * current_;
+    chunk * chunks_;
+
+    // The offset of the free space in buffer_ or current_.
+    std::size_t used_;
+
+    std::size_t objects_;
+
+    SOCI_NOT_COPYABLE(exchange_arena)
+};
+
+// Makes the elements created during the lifetime of this object use the given
+// arena, which may be null to use the heap.
+class SOCI_DECL exchange_arena_scope
+{
+public:
+    explicit exchange_arena_scope(exchange_arena * arena);
+    ~exchange_arena_scope();
+
+private:
+    exchange_arena * previous_;
+
+    SOCI_NOT_COPYABLE(exchange_arena_scope)
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_EXCHANGE_ARENA_H_INCLUDED
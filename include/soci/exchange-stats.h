@@ -0,0 +1,116 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_EXCHANGE_STATS_H_INCLUDED
+#define SOCI_EXCHANGE_STATS_H_INCLUDED
+
+#include "soci/soci-platform.h"
+// std
+#include <cstddef>
+
+namespace soci
+{
+
+// Counters of the work done when exchanging data with the database.
+//
+// They are only updated if SOCI was built with SOCI_INSTRUMENTATION option,
+// i.e. SOCI_HAVE_INSTRUMENTATION is defined, and are always 0 otherwise.
+struct exchange_stats
+{
+    exchange_stats()
+        : executes(0), fetches(0), exchangeCalls(0),
+          allocations(0), bytesAllocated(0), bytesCopied(0)
+    {
+    }
+
+    // Number of statement execute() and fetch() calls.
+    std::size_t executes;
+    std::size_t fetches;
+
+    // Number of calls to pre_exec(), pre_fetch(), post_fetch(), pre_use() and
+    // post_use() of the individual into and use elements.
+    std::size_t exchangeCalls;
+
+    // Number of heap allocations done by SOCI itself, i.e. not counting the
+    // ones done by the database client libraries, and their total size, or
+    // of all allocations if details::set_allocation_hook() is used.
+    std::size_t allocations;
+    std::size_t bytesAllocated;
+
+    // Number of bytes copied between the database buffers and the variables.
+    std::size_t bytesCopied;
+
+    exchange_stats & operator+=(exchange_stats const & other)
+    {
+        executes += other.executes;
+        fetches += other.fetches;
+        exchangeCalls += other.exchangeCalls;
+        allocations += other.allocations;
+        bytesAllocated += other.bytesAllocated;
+        bytesCopied += other.bytesCopied;
+        return *this;
+    }
+};
+
+namespace details
+{
+
+#ifdef SOCI_HAVE_INSTRUMENTATION
+
+// Return the counters for the work done in the current thread.
+SOCI_DECL exchange_stats & get_thread_exchange_stats();
+
+// Function filling the number and the total size of all heap allocations
+// done in the current thread until now.
+typedef void (*allocation_hook)(std::size_t & allocations, std::size_t & bytes);
+
+// By default, only the allocations done at SOCI own allocation points, e.g.
+// the exchange arena, are counted, but not those done by the standard
+// containers used by the core or the backends. A program replacing the
+// global operator new can count all of them itself and use this function to
+// make the statistics use its counters instead. Pass null to reset it.
+SOCI_DECL void set_allocation_hook(allocation_hook hook);
+
+// Return a copy of the counters for the current thread, with the allocation
+// counters taken from the hook, if any.
+SOCI_DECL exchange_stats get_thread_exchange_stats_snapshot();
+
+// Record a heap allocation of the given size done by SOCI.
+inline void count_allocation(std::size_t size)
+{
+    exchange_stats & stats = get_thread_exchange_stats();
+    ++stats.allocations;
+    stats.bytesAllocated += size;
+}
+
+// Record copying the given number of bytes of data.
+inline void count_bytes_copied(std::size_t bytes)
+{
+    get_thread_exchange_stats().bytesCopied += bytes;
+}
+
+// Record calling the exchange functions of the given number of elements.
+inline void count_exchange_calls(std::size_t calls)
+{
+    get_thread_exchange_stats().exchangeCalls += calls;
+}
+
+#else // !SOCI_HAVE_INSTRUMENTATION
+
+// Do nothing versions which are optimized away.
+typedef void (*allocation_hook)(std::size_t & allocations, std::size_t & bytes);
+inline void set_allocation_hook(allocation_hook) {}
+inline void count_allocation(std::size_t) {}
+inline void count_bytes_copied(std::size_t) {}
+inline void count_exchange_calls(std::size_t) {}
+
+#endif // SOCI_HAVE_INSTRUMENTATION
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_EXCHANGE_STATS_H_INCLUDED
@@ -26,6 +26,12 @@
 #include <vector>
 #include <string>
 
+// The batch API used for bulk operations is only available in the client
+// library of Firebird 4 and later.
+#if defined(FB_API_VER) && FB_API_VER >= 40
+# define SOCI_FIREBIRD_HAS_BATCH
+#endif
+
 namespace soci
 {
 
@@ -209,6 +215,8 @@ struct firebird_statement_backend : details::statement_backend
     firebird_vector_into_type_backend * make_vector_into_type_backend() override;
     firebird_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    int get_exchange_hooks() const override { return 0; }
+
     firebird_session_backend &session_;
 
     isc_stmt_handle stmtp_;
@@ -231,6 +239,11 @@ protected:
 
     virtual void exchangeData(bool gotData, int row);
     virtual void prepareSQLDA(XSQLDA ** sqldap, short size = 10);
+
+    // Execute the statement for all the given rows of the vector use elements
+    // using Firebird batch API. Returns false if batches can't be used, e.g.
+    // because the server is too old, and the rows must be executed one by one.
+    bool execute_batch(std::size_t rows);
     virtual void rewriteQuery(std::string const & query,
         std::vector<char> & buffer);
     virtual void rewriteParameters(std::string const & src,
@@ -288,17 +301,35 @@ struct firebird_blob_backend : details::blob_backend
 protected:
 
     virtual void open();
+    virtual void close();
     virtual long getBLOBInfo();
     virtual void load();
     virtual void writeBuffer(std::size_t offset, char const * buf,
         std::size_t toWrite);
     virtual void cleanUp();
 
-    // buffer for BLOB data
+    // Helpers for streaming the BLOB data from or to the database segment by
+    // segment, without keeping all of it in memory.
+    std::size_t readSegments(char * buf, std::size_t toRead);
+    void writeSegments(char const * buf, std::size_t toWrite);
+    void finishWriting();
+    bool isStreamingWrite(std::size_t offset) const;
+
+    // buffer for BLOB data, only used if it was loaded or modified in place
     std::vector<char> data_;
 
     bool loaded_;
     long max_seg_size_;
+
+    // total length of the BLOB opened for reading or the number of bytes
+    // already written to it
+    std::size_t len_;
+
+    // position of the next byte to be read from the opened BLOB
+    std::size_t readPos_;
+
+    // the BLOB was created and is being written sequentially
+    bool writing_;
 };
 
 struct firebird_session_backend : details::session_backend
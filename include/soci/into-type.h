@@ -10,6 +10,7 @@
 
 #include "soci/soci-backend.h"
 #include "soci/type-ptr.h"
+#include "soci/exchange-arena.h"
 #include "soci/exchange-traits.h"
 // std
 #include <cstddef>
@@ -35,6 +36,13 @@ class into_type_base
 public:
     virtual ~into_type_base() {}
 
+    // Elements are allocated from the arena of the statement using them, if
+    // possible, see exchange_arena.
+    static void * operator new(std::size_t size)
+    { return exchange_arena::allocate_object(size); }
+    static void operator delete(void * p)
+    { exchange_arena::deallocate_object(p); }
+
     virtual void define(statement_impl & st, int & position) = 0;
     virtual void pre_exec(int num) = 0;
     virtual void pre_fetch() = 0;
@@ -43,6 +51,15 @@ public:
 
     virtual std::size_t size() const = 0;  // returns the number of elements
     virtual void resize(std::size_t /* sz */) {} // used for vectors only
+
+    // Only vectors can have size different from 1.
+    virtual bool is_vector() const { return false; }
+
+    // Return false if pre_exec() and pre_fetch() don't do anything except
+    // forwarding to the backend element, which allows to skip calling them
+    // if the backend doesn't need them. Classes overriding these functions
+    // of the standard elements must override this one to return true.
+    virtual bool has_own_hooks() const { return true; }
 };
 
 typedef type_ptr<into_type_base> into_type_ptr;
@@ -72,6 +89,7 @@ private:
     void define(statement_impl & st, int & position) override;
     void pre_exec(int num) override;
     void pre_fetch() override;
+    bool has_own_hooks() const override { return false; }
     void clean_up() override;
 
     std::size_t size() const override { return 1; }
@@ -118,9 +136,11 @@ protected:
     void define(statement_impl & st, int & position) override;
     void pre_exec(int num) override;
     void pre_fetch() override;
+    bool has_own_hooks() const override { return false; }
     void clean_up() override;
     void resize(std::size_t sz) override;
     std::size_t size() const override;
+    bool is_vector() const override { return true; }
 
     void * data_;
     exchange_type type_;
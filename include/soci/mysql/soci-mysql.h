@@ -189,6 +189,8 @@ struct mysql_statement_backend : details::statement_backend
     mysql_vector_into_type_backend * make_vector_into_type_backend() override;
     mysql_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    int get_exchange_hooks() const override { return 0; }
+
     mysql_session_backend &session_;
 
     MYSQL_RES *result_;
@@ -25,6 +25,12 @@
 #include <sqlext.h> // ODBC
 #include <string.h> // strcpy()
 
+// ODBC 3.8 driver managers under Windows can notify about the completion of
+// asynchronous operations using events instead of requiring polling.
+#if (defined(_MSC_VER) || defined(__MINGW32__)) && defined(SQL_ATTR_ASYNC_STMT_EVENT)
+# define SOCI_ODBC_HAS_ASYNC_EVENT
+#endif
+
 namespace soci
 {
 
@@ -51,6 +57,11 @@ namespace details
 // string form as all options are strings currently).
 extern SOCI_ODBC_DECL char const * odbc_option_driver_complete;
 
+// Option enabling row-wise binding for the vector into elements by default
+// for all statements using the session, see odbc_statement_backend. Its value
+// must be option_true to enable it.
+extern SOCI_ODBC_DECL char const * odbc_option_row_wise_binding;
+
 struct odbc_statement_backend;
 
 // Helper of into and use backends.
@@ -115,7 +126,8 @@ struct odbc_vector_into_type_backend : details::vector_into_type_backend,
 {
     odbc_vector_into_type_backend(odbc_statement_backend &st)
         : odbc_standard_type_backend_base(st),
-          data_(NULL), buf_(NULL), position_(0) {}
+          data_(NULL), buf_(NULL), position_(0), longColumn_(false),
+          rowBuf_(NULL), rowSize_(0), valueOffset_(0), indOffset_(0) {}
 
     void define_by_pos(int &position,
         void *data, details::exchange_type type) override;
@@ -142,6 +154,33 @@ struct odbc_vector_into_type_backend : details::vector_into_type_backend,
     // Used when vector values are fetched by single row.
     void rebind_row(std::size_t rowInd);
 
+    // Size of the buffer needed for a single value of this column when
+    // using row-wise binding.
+    std::size_t get_row_element_size() const;
+
+    // Bind this column to the buffer used for row-wise binding, whose rows
+    // have the given size, using the given offsets for the value and the
+    // indicator in each row.
+    void bind_row_wise(char *rowBuf, std::size_t rowSize,
+                       std::size_t valueOffset, std::size_t indOffset);
+
+    // Copy the values of the given number of rows fetched into the buffer
+    // bound by bind_row_wise() into the vector.
+    void do_post_fetch_row_wise(std::size_t rows);
+
+    // Retrieve the value of the long column in the current row of the
+    // current rowset using SQLGetData() and store it at the given index.
+    void get_long_value(std::size_t rowInd);
+
+    // Bind the long column to a buffer big enough for any value instead of
+    // using get_long_value(), this requires fetching the rows one by one.
+    // Used when the driver doesn't allow using SQLGetData() for it.
+    void bind_long_column();
+
+    // IBM DB2 driver is not compliant to ODBC spec for indicators in 64bit
+    // SQLLEN is still defined 32bit (int) but spec requires 64bit (long)
+    inline void set_sqllen_from_vector_at(const std::size_t idx, const SQLLEN val);
+
     std::vector<SQLLEN> indHolderVec_;
     void *data_;
     char *buf_;              // generic buffer
@@ -149,6 +188,21 @@ struct odbc_vector_into_type_backend : details::vector_into_type_backend,
     std::size_t colSize_;    // size of the string column (used for strings)
     SQLSMALLINT odbcType_;
     int position_;
+
+    // True for the string columns too big to be bound, whose values are
+    // retrieved by get_long_value() after fetching each rowset instead.
+    bool longColumn_;
+    // Buffer and layout used with row-wise binding, if it's used.
+    char *rowBuf_;
+    std::size_t rowSize_;
+    std::size_t valueOffset_;
+    std::size_t indOffset_;
+
+private:
+    // Convert the values stored in the given buffer, with the given distance
+    // between them, for the types not using the vector elements directly.
+    void copy_from_buffer(char const *buf, std::size_t stride,
+                          std::size_t beginRow, std::size_t endRow);
 };
 
 struct odbc_standard_use_type_backend : details::standard_use_type_backend,
@@ -244,6 +298,12 @@ struct odbc_statement_backend : details::statement_backend
     exec_fetch_result execute(int number) override;
     exec_fetch_result fetch(int number) override;
 
+    // Asynchronous execution is only used if the driver supports it.
+    bool start_async_execute(int number) override;
+    bool poll_async_execute(bool wait) override;
+    exec_fetch_result complete_async_execute() override;
+    void cancel_async_execute() override;
+
     long long get_affected_rows() override;
     int get_number_of_rows() override;
     std::string get_parameter_name(int index) const override;
@@ -262,6 +322,8 @@ struct odbc_statement_backend : details::statement_backend
     odbc_vector_into_type_backend * make_vector_into_type_backend() override;
     odbc_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    int get_exchange_hooks() const override { return 0; }
+
     odbc_session_backend &session_;
     SQLHSTMT hstmt_;
     SQLULEN numRowsFetched_;
@@ -272,6 +334,12 @@ struct odbc_statement_backend : details::statement_backend
 
     long long rowsAffected_; // number of rows affected by the last operation
 
+    // Enable or disable binding the vector into elements row-wise for this
+    // statement, overriding the session odbc_option_row_wise_binding value.
+    // This can be changed between fetches.
+    SOCI_ODBC_DECL void set_row_wise_binding(bool rowWise);
+    bool get_row_wise_binding() const { return rowWiseBinding_; }
+
     std::string query_;
     std::vector<std::string> names_; // list of names for named binds
 
@@ -280,8 +348,65 @@ struct odbc_statement_backend : details::statement_backend
     std::vector<odbc_vector_into_type_backend*> intos_;
 
 private:
+    // Throw if the statement is still being executed asynchronously.
+    void check_not_executing() const;
+
+    // execute() and start_async_execute() helpers: the first one must be
+    // called before SQLExecute() and the second one processes its result.
+    void prepare_execute();
+    exec_fetch_result complete_execute(SQLRETURN rc, int number);
+
+    // Switch back to synchronous mode after asynchronous execution.
+    void end_async_mode();
+
+    // Number of parameter sets processed by the last execution, only used if
+    // hasVectorUseElements_ is true.
+    SQLULEN paramsProcessed_;
+
+    // Result of the last SQLExecute() call while executing asynchronously,
+    // i.e. SQL_STILL_EXECUTING until it completes, and the flag which is true
+    // if the statement is in asynchronous mode.
+    SQLRETURN asyncRc_;
+    bool asyncMode_;
+
+    // Number of rows to fetch once the asynchronous execution completes.
+    int asyncNumber_;
+
+#ifdef SOCI_ODBC_HAS_ASYNC_EVENT
+    // Event signaled by the driver manager when the execution completes, only
+    // used if the driver supports notifications, null otherwise.
+    HANDLE asyncEvent_;
+#endif
+
     // fetch() helper wrapping SQLFetch() call for the given range of rows.
     exec_fetch_result do_fetch(int beginRow, int endRow);
+
+    // fetch() helper checking if the values of the long columns, if any, can
+    // be retrieved using SQLGetData() and binding them to the buffers if not.
+    void prepare_long_columns();
+
+    // Long vector into elements, retrieved using SQLGetData() in do_fetch().
+    std::vector<odbc_vector_into_type_backend*> longIntos_;
+
+    // fetch() helper binding all vector into elements row-wise for fetching
+    // the given number of rows, returns the size of a row.
+    std::size_t bind_row_wise(int number);
+
+    // Bind the vector into elements back to their own buffers if they're
+    // currently bound row-wise.
+    void unbind_row_wise();
+
+    // If true, the vector into elements are bound row-wise to a single buffer
+    // containing all values of each row together instead of binding each of
+    // them to its own buffer. This can be faster for wide result sets, but
+    // requires copying the values of all columns, so it's off by default.
+    // Initialized from the session value.
+    bool rowWiseBinding_;
+
+    // Buffer used with row-wise binding and the flag indicating whether it's
+    // used by the current fetch() call.
+    std::vector<char> rowBuf_;
+    bool boundRowWise_;
 };
 
 struct odbc_rowid_backend : details::rowid_backend
@@ -352,6 +477,12 @@ struct odbc_session_backend : details::session_backend
     // Determine the type of the database we're connected to.
     SOCI_ODBC_DECL database_product get_database_product() const;
 
+    // Return the SQL_GETDATA_EXTENSIONS supported by the driver.
+    SQLUINTEGER get_data_extensions() const;
+
+    // Return true if the driver supports asynchronous statement execution.
+    bool supports_async_execution() const;
+
     // Return full ODBC connection string.
     std::string get_connection_string() const { return connection_string_; }
 
@@ -360,8 +491,18 @@ struct odbc_session_backend : details::session_backend
 
     std::string connection_string_;
 
+    // Default value of odbc_statement_backend::rowWiseBinding_.
+    bool rowWiseBinding_;
+
 private:
     mutable database_product product_;
+
+    // Cached value returned by get_data_extensions(), if valid.
+    mutable SQLUINTEGER getDataExtensions_;
+    mutable bool getDataExtensionsValid_;
+
+    // Cached value of SQL_ASYNC_MODE, or -1 if not retrieved yet.
+    mutable int asyncMode_;
 };
 
 class SOCI_ODBC_DECL odbc_soci_error : public soci_error
@@ -554,6 +695,30 @@ inline SQLLEN odbc_vector_into_type_backend::get_sqllen_from_vector_at(std::size
     return indHolderVec_[idx];
 }
 
+inline void odbc_vector_into_type_backend::set_sqllen_from_vector_at(const std::size_t idx, const SQLLEN val)
+{
+    if (requires_noncompliant_32bit_sqllen())
+    {
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wstrict-aliasing"
+#endif
+        reinterpret_cast<int*>(&indHolderVec_[0])[idx] = *reinterpret_cast<const int*>(&val);
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
+    }
+    else
+    {
+        indHolderVec_[idx] = val;
+    }
+}
+
 inline void odbc_vector_use_type_backend::set_sqllen_from_vector_at(const std::size_t idx, const SQLLEN val)
 {
     if (requires_noncompliant_32bit_sqllen())
@@ -278,6 +278,8 @@ struct postgresql_statement_backend : details::statement_backend
     postgresql_vector_into_type_backend * make_vector_into_type_backend() override;
     postgresql_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    int get_exchange_hooks() const override { return 0; }
+
     postgresql_session_backend & session_;
 
     bool single_row_mode_;
@@ -43,6 +43,7 @@ private:
 
     void pre_exec(int /* num */) override {}
     void pre_fetch() override {}
+    bool has_own_hooks() const override { return false; }
     void post_fetch(bool gotData, bool /* calledFromFetch */) override
     {
         r_.reset_get_counter();
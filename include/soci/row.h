@@ -13,10 +13,20 @@
 #include "soci/type-conversion.h"
 // std
 #include <cstddef>
-#include <map>
+#include <ctime>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#ifdef SOCI_HAVE_CXX17
+#include <string_view>
+#endif
+
 namespace soci
 {
 
@@ -37,14 +47,47 @@ private:
     data_type dataType_;
 };
 
+namespace details
+{
+
+class statement_impl;
+
+} // namespace details
+
+class row;
+
+// Handle of a column of a row, which can be used instead of its name or
+// position to access the values of this column.
+//
+// Looking up the column by its name only needs to be done once, when the
+// handle is created by row::get_column_handle(), and the handle can then be
+// used with all the rows fetched by the same statement. Using it with a row
+// describing the columns of a different query results in an exception.
+class column_handle
+{
+public:
+    column_handle() : pos_(0), descriptionId_(0) {}
+
+    std::size_t get_position() const { return pos_; }
+
+private:
+    friend class row;
+
+    column_handle(std::size_t pos, unsigned long descriptionId)
+        : pos_(pos), descriptionId_(descriptionId) {}
+
+    std::size_t pos_;
+    unsigned long descriptionId_;
+};
+
 class SOCI_DECL row
 {
 public:
     row();
     ~row();
 
-    row(row &&other) = default;
-    row &operator=(row &&other) = default;
+    row(row &&other);
+    row &operator=(row &&other);
 
     void uppercase_column_names(bool forceToUpper);
     void add_properties(column_properties const& cp);
@@ -54,31 +97,38 @@ public:
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const& name) const;
 
-    template <typename T>
-    inline void add_holder(T* t, indicator* ind)
+    column_properties const& get_properties(std::size_t pos) const;
+    column_properties const& get_properties(std::string const& name) const;
+
+    // Find the column with the given name and return its handle, throws if
+    // there is no such column.
+    column_handle get_column_handle(std::string const& name) const;
+
+    indicator get_indicator(column_handle const& h) const
     {
-        holders_.push_back(new details::type_holder<T>(t));
-        indicators_.push_back(ind);
+        return get_indicator(get_position(h));
     }
 
-    column_properties const& get_properties(std::size_t pos) const;
-    column_properties const& get_properties(std::string const& name) const;
+    column_properties const& get_properties(column_handle const& h) const
+    {
+        return get_properties(get_position(h));
+    }
 
     template <typename T>
     T get(std::size_t pos) const
     {
         typedef typename type_conversion<T>::base_type base_type;
-        base_type const& baseVal = holders_.at(pos)->get<base_type>();
+        base_type const& baseVal = get_holder(pos).template get<base_type>();
 
         T ret;
-        type_conversion<T>::from_base(baseVal, *indicators_.at(pos), ret);
+        type_conversion<T>::from_base(baseVal, indicators_[pos], ret);
         return ret;
     }
 
     template <typename T>
     T get(std::size_t pos, T const &nullValue) const
     {
-        if (i_null == *indicators_.at(pos))
+        if (i_null == get_indicator(pos))
         {
             return nullValue;
         }
@@ -98,7 +148,7 @@ public:
     {
         std::size_t const pos = find_column(name);
 
-        if (i_null == *indicators_[pos])
+        if (i_null == indicators_[pos])
         {
             return nullValue;
         }
@@ -106,6 +156,86 @@ public:
         return get<T>(pos);
     }
 
+    // Return a reference to the value stored in the row without copying it.
+    //
+    // T must be one of the types used for storing the values, i.e.
+    // std::string (also used for BLOB and XML columns), double, int,
+    // long long, unsigned long long or std::tm. The returned reference is
+    // only valid until the next fetch.
+    template <typename T>
+    T const& get_ref(std::size_t pos) const
+    {
+        static_assert(details::row_value_traits<T>::type != -1,
+                      "get_ref() can't be used with this type");
+
+        details::value_holder const& h = get_holder(pos);
+        if (i_null == indicators_[pos])
+        {
+            throw soci_error("Null value not allowed for this type");
+        }
+
+        return h.get<T>();
+    }
+
+    template <typename T>
+    T const& get_ref(std::string const &name) const
+    {
+        return get_ref<T>(find_column(name));
+    }
+
+#ifdef SOCI_HAVE_CXX17
+    std::string_view get_string_view(std::size_t pos) const
+    {
+        return get_ref<std::string>(pos);
+    }
+
+    std::string_view get_string_view(std::string const &name) const
+    {
+        return get_ref<std::string>(name);
+    }
+#endif // SOCI_HAVE_CXX17
+
+    // Return the value moving it out of the row if possible, i.e. if T is the
+    // type used for storing it, and just copying it otherwise. This is useful
+    // for consuming the row values, as the moved-from value can't be
+    // retrieved again until the next fetch.
+    template <typename T>
+    T move_as(std::size_t pos)
+    {
+        typedef typename type_conversion<T>::base_type base_type;
+        return do_move_as<T>(pos, std::is_same<T, base_type>());
+    }
+
+    template <typename T>
+    T move_as(std::string const &name)
+    {
+        return move_as<T>(find_column(name));
+    }
+
+    template <typename T>
+    T get(column_handle const& h) const
+    {
+        return get<T>(get_position(h));
+    }
+
+    template <typename T>
+    T get(column_handle const& h, T const &nullValue) const
+    {
+        return get<T>(get_position(h), nullValue);
+    }
+
+    template <typename T>
+    T const& get_ref(column_handle const& h) const
+    {
+        return get_ref<T>(get_position(h));
+    }
+
+    template <typename T>
+    T move_as(column_handle const& h)
+    {
+        return move_as<T>(get_position(h));
+    }
+
     template <typename T>
     row const& operator>>(T& value) const
     {
@@ -127,12 +257,68 @@ public:
 private:
     SOCI_NOT_COPYABLE(row)
 
+    friend class details::statement_impl;
+
+    // Allocate storage for the values of all columns added by
+    // add_properties(), this is done only once per statement.
+    void allocate_storage();
+
+    details::value_holder& get_holder(std::size_t pos) const
+    {
+        if (pos >= numValues_)
+        {
+            throw std::out_of_range("Invalid column position");
+        }
+
+        return values_[pos];
+    }
+
+    template <typename T>
+    T do_move_as(std::size_t pos, std::true_type /* is base type */)
+    {
+        details::value_holder& h = get_holder(pos);
+        if (i_null == indicators_[pos])
+        {
+            throw soci_error("Null value not allowed for this type");
+        }
+
+        return std::move(h.get<T>());
+    }
+
+    template <typename T>
+    T do_move_as(std::size_t pos, std::false_type /* is base type */)
+    {
+        // Conversions only work with const references, so just copy.
+        return get<T>(pos);
+    }
+
     std::size_t find_column(std::string const& name) const;
 
+    std::size_t get_position(column_handle const& h) const
+    {
+        if (h.descriptionId_ != descriptionId_ || descriptionId_ == 0)
+        {
+            throw soci_error("Column handle can't be used with this row");
+        }
+
+        return h.pos_;
+    }
+
     std::vector<column_properties> columns_;
-    std::vector<details::holder*> holders_;
-    std::vector<indicator*> indicators_;
-    std::map<std::string, std::size_t> index_;
+
+    // Single block containing the values of all columns followed by their
+    // indicators, values_ and indicators_ point into it.
+    std::unique_ptr<char[]> storage_;
+    details::value_holder* values_;
+    indicator* indicators_;
+    std::size_t numValues_;
+
+    std::unordered_map<std::string, std::size_t> index_;
+
+    // Unique identifier of the current description of the columns, used to
+    // check that the column handles are used with the right rows. It is 0 if
+    // the storage hadn't been allocated yet.
+    unsigned long descriptionId_;
 
     bool uppercaseColumnNames_;
     mutable std::size_t currentPos_;
@@ -205,6 +205,41 @@ public:
     virtual vector_into_type_backend* make_vector_into_type_backend() = 0;
     virtual vector_use_type_backend* make_vector_use_type_backend() = 0;
 
+    // Optional hooks of the into and use backends, which are not called at
+    // all if the backend doesn't need them.
+    enum exchange_hook
+    {
+        eh_pre_exec = 1,
+        eh_pre_fetch = 2
+    };
+
+    // Return the combination of exchange_hook values for the hooks of the
+    // into and use backends which must be called. By default all of them
+    // are called, backends implementing these hooks as no-ops (which is the
+    // case of all of them except Oracle) override this function to return 0
+    // to avoid the overhead of calling them.
+    //
+    // Notice that this only affects the into and use elements forwarding
+    // these hooks to the backend, see into_type_base::has_own_hooks().
+    virtual int get_exchange_hooks() const { return eh_pre_exec | eh_pre_fetch; }
+
+    // Optional support for asynchronous execution used by
+    // statement::execute_async().
+    //
+    // start_async_execute() starts executing the statement just as execute()
+    // would, but without waiting for it to complete, and returns true, or
+    // returns false if this is not supported, in which case execute() is
+    // called instead. If it returns true, poll_async_execute() is called to
+    // check if the execution has completed, optionally waiting for it, and,
+    // once it returns true, complete_async_execute() is called to return the
+    // same result as execute() would have returned or throw.
+    virtual bool start_async_execute(int /* number */) { return false; }
+    virtual bool poll_async_execute(bool /* wait */) { return true; }
+    virtual exec_fetch_result complete_async_execute() { return ef_no_data; }
+
+    // Request cancelling the asynchronous execution if it's still running.
+    virtual void cancel_async_execute() {}
+
 private:
     SOCI_NOT_COPYABLE(statement_backend)
 };
@@ -16,6 +16,8 @@
 #include "soci/column-info.h"
 #include "soci/connection-pool.h"
 #include "soci/error.h"
+#include "soci/exchange-arena.h"
+#include "soci/exchange-stats.h"
 #include "soci/exchange-traits.h"
 #include "soci/into.h"
 #include "soci/into-type.h"
@@ -38,6 +40,7 @@
 #include "soci/type-holder.h"
 #include "soci/type-ptr.h"
 #include "soci/type-wrappers.h"
+#include "soci/typed-statement.h"
 #include "soci/unsigned-types.h"
 #include "soci/use.h"
 #include "soci/use-type.h"
@@ -17,8 +17,18 @@
 #endif
 
 #include <cstdarg>
+#include <ctime>
+#include <exception>
+#include <list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <soci/soci-backend.h>
+#include <soci/connection-pool.h>
+#include <soci/exchange-traits.h>
 
 // Disable flood of nonsense warnings generated for SQLite
 #ifdef _MSC_VER
@@ -87,7 +97,8 @@ struct sqlite3_standard_into_type_backend : details::standard_into_type_backend
 struct sqlite3_vector_into_type_backend : details::vector_into_type_backend
 {
     sqlite3_vector_into_type_backend(sqlite3_statement_backend &st)
-        : statement_(st), data_(0), type_(), position_(0)
+        : statement_(st), data_(0), type_(), position_(0),
+          fetchedDirectly_(false)
     {
     }
 
@@ -101,11 +112,24 @@ struct sqlite3_vector_into_type_backend : details::vector_into_type_backend
 
     void clean_up() override;
 
+    // Check if the values of the column with the given type can be stored
+    // directly in the vector when stepping through the rows, without going
+    // through the statement row cache, and prepare for doing it if so.
+    bool prepare_direct_fetch(data_type colType, std::size_t rows);
+
+    // Store the value of the current row of the statement at the given index.
+    void fetch_directly(std::size_t row);
+
     sqlite3_statement_backend& statement_;
 
     void *data_;
     details::exchange_type type_;
     int position_;
+
+    // Indicators of the rows stored by fetch_directly(), only used if
+    // fetchedDirectly_ is true.
+    std::vector<indicator> directInds_;
+    bool fetchedDirectly_;
 };
 
 struct sqlite3_standard_use_type_backend : details::standard_use_type_backend
@@ -133,7 +157,7 @@ struct sqlite3_standard_use_type_backend : details::standard_use_type_backend
 struct sqlite3_vector_use_type_backend : details::vector_use_type_backend
 {
     sqlite3_vector_use_type_backend(sqlite3_statement_backend &st)
-        : statement_(st), data_(0), type_(), position_(0)
+        : statement_(st), data_(0), type_(), position_(0), ind_(0)
     {
     }
 
@@ -148,12 +172,25 @@ struct sqlite3_vector_use_type_backend : details::vector_use_type_backend
 
     void clean_up() override;
 
+    // Bind the element of the vector with the given index to the statement,
+    // directly using the data stored in the vector whenever possible.
+    void bind_row(std::size_t row);
+
     sqlite3_statement_backend &statement_;
 
     void *data_;
     details::exchange_type type_;
     int position_;
     std::string name_;
+
+    // Indicators passed to pre_use(), may be null.
+    indicator const *ind_;
+
+    // Buffer used for the string representation of the bound std::tm value.
+    char tmBuffer_[20];
+
+private:
+    void register_with_statement();
 };
 
 struct sqlite3_column_buffer
@@ -181,7 +218,66 @@ struct sqlite3_column
 };
 
 typedef std::vector<sqlite3_column> sqlite3_row;
-typedef std::vector<sqlite3_row> sqlite3_recordset;
+typedef std::vector<sqlite3_row> sqlite3_use_data;
+
+// Simple bump allocator used for the variable length values of the fetched
+// rows: the memory is only released when the arena is destroyed and reset()
+// makes it available for the next fetch without freeing it.
+class SOCI_SQLITE3_DECL sqlite3_arena
+{
+public:
+    sqlite3_arena() : current_(0), used_(0) {}
+
+    // Return a buffer of the given size valid until the next reset().
+    char *allocate(std::size_t size);
+
+    // Forget all previously allocated buffers, keeping the memory.
+    void reset();
+
+private:
+    typedef std::vector<char> chunk;
+
+    std::vector<chunk> chunks_;
+    std::size_t current_;
+    std::size_t used_;
+};
+
+// Rows loaded by a bulk fetch.
+//
+// The cells are stored in a single column-major vector (i.e. all the values
+// of the first column come first, then all the values of the second one and
+// so on) and the string and blob values point into the arena, so neither of
+// them needs to be reallocated when the same statement is fetched again.
+class SOCI_SQLITE3_DECL sqlite3_recordset
+{
+public:
+    sqlite3_recordset() : rows_(0), capacity_(0), columns_(0) {}
+
+    // Prepare for loading up to the given number of rows, invalidating all
+    // the previously loaded values.
+    void reset(std::size_t rows, std::size_t columns);
+
+    // Set the number of rows actually loaded, must not exceed the number
+    // passed to reset().
+    void set_size(std::size_t rows) { rows_ = rows; }
+
+    std::size_t size() const { return rows_; }
+    bool empty() const { return rows_ == 0; }
+
+    sqlite3_column &at(std::size_t row, std::size_t column)
+    {
+        return cells_[column * capacity_ + row];
+    }
+
+    char *allocate(std::size_t size) { return arena_.allocate(size); }
+
+private:
+    std::vector<sqlite3_column> cells_;
+    sqlite3_arena arena_;
+    std::size_t rows_;
+    std::size_t capacity_;
+    std::size_t columns_;
+};
 
 
 struct sqlite3_column_info
@@ -221,10 +317,13 @@ struct sqlite3_statement_backend : details::statement_backend
     sqlite3_vector_into_type_backend * make_vector_into_type_backend() override;
     sqlite3_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    int get_exchange_hooks() const override { return 0; }
+
     sqlite3_session_backend &session_;
     sqlite_api::sqlite3_stmt *stmt_;
+    std::string query_; // the query used to prepare stmt_
     sqlite3_recordset dataCache_;
-    sqlite3_recordset useData_;
+    sqlite3_use_data useData_;
     bool databaseReady_;
     bool boundByName_;
     bool boundByPos_;
@@ -234,7 +333,30 @@ struct sqlite3_statement_backend : details::statement_backend
     bool hasVectorIntoElements_;
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
+    // Change the number of rows committed together by the bulk operations
+    // executed outside of a transaction by this statement, overriding the
+    // session bulk_batch_size value. Throws if the size is negative.
+    SOCI_SQLITE3_DECL void set_bulk_batch_size(int size);
+    int get_bulk_batch_size() const { return bulkBatchSize_; }
+
+    // Vector into elements indexed by their (0-based) column position, the
+    // elements may be null if there is no vector into for this column.
+    std::vector<sqlite3_vector_into_type_backend *> vectorIntos_;
+
+    // All vector use elements: unlike the standard ones, which are stored
+    // in useData_, they bind the data directly from the vectors.
+    std::vector<sqlite3_vector_use_type_backend *> vectorUses_;
+
 private:
+    // If positive, bulk operations executed outside of a transaction are
+    // committed in batches of this many rows using a savepoint, instead of
+    // committing each row separately. Initialized from the session value.
+    int bulkBatchSize_;
+
+    // Columns whose values are fetched directly into the vector into
+    // elements by load_rowset(), null for the columns using dataCache_.
+    std::vector<sqlite3_vector_into_type_backend *> directIntos_;
+
     exec_fetch_result load_rowset(int totalRows);
     exec_fetch_result load_one();
     exec_fetch_result bind_and_execute(int number);
@@ -264,6 +386,28 @@ struct sqlite3_blob_backend : details::blob_backend
     std::size_t append(char const *buf, std::size_t toWrite) override;
     void trim(std::size_t newLen) override;
 
+    // Open the BLOB stored in the given column of the row with the given
+    // rowid for incremental I/O: after this, all read and write operations
+    // work directly with the data in the database instead of keeping a copy
+    // of the entire BLOB in memory.
+    //
+    // Notice that the size of the BLOB can't be changed while it is open, so
+    // append() and trim() throw, use "zeroblob(N)" in SQL to create a BLOB of
+    // the required size before opening it.
+    SOCI_SQLITE3_DECL void open(std::string const &table,
+                                std::string const &column,
+                                sqlite_api::sqlite3_int64 rowid,
+                                bool readOnly = false,
+                                std::string const &database = "main");
+
+    // Switch the BLOB opened by open() to another row of the same table.
+    SOCI_SQLITE3_DECL void reopen(sqlite_api::sqlite3_int64 rowid);
+
+    // Close the BLOB opened by open(), does nothing if it's not open.
+    SOCI_SQLITE3_DECL void close();
+
+    bool is_open() const { return blob_ != NULL; }
+
     sqlite3_session_backend &session_;
 
     std::size_t set_data(char const *buf, std::size_t toWrite);
@@ -272,6 +416,227 @@ struct sqlite3_blob_backend : details::blob_backend
 private:
     char *buf_;
     size_t len_;
+
+    // Handle used for incremental I/O, null unless open() was called.
+    sqlite_api::sqlite3_blob *blob_;
+};
+
+namespace details
+{
+
+// Helpers used by the functions defined in C++ and registered with
+// sqlite3_session_backend::create_function() and create_aggregate(): they
+// are not templates and only wrap the SQLite API.
+
+// Convert the function argument to the given type, NULL is converted to the
+// default value of the type, as SQLite does.
+SOCI_SQLITE3_DECL void sqlite3_get_function_arg(sqlite_api::sqlite3_value *arg,
+                                                exchange_type type, void *data);
+
+// Set the function result of the given type.
+SOCI_SQLITE3_DECL void sqlite3_set_function_result(sqlite_api::sqlite3_context *ctx,
+                                                   exchange_type type,
+                                                   void const *data);
+
+SOCI_SQLITE3_DECL void sqlite3_set_function_error(sqlite_api::sqlite3_context *ctx,
+                                                  char const *msg);
+
+SOCI_SQLITE3_DECL void *sqlite3_get_function_data(sqlite_api::sqlite3_context *ctx);
+
+// Return the pointer to the state of the aggregate for the current group,
+// which is initially null, or null if there is no state and create is false.
+SOCI_SQLITE3_DECL void **sqlite3_get_aggregate_state(sqlite_api::sqlite3_context *ctx,
+                                                     bool create);
+
+template <typename T>
+T sqlite3_function_arg(sqlite_api::sqlite3_value *arg)
+{
+    static_assert(std::is_same<typename exchange_traits<T>::type_family,
+                               basic_type_tag>::value,
+                  "Only basic types can be used with SQLite functions");
+
+    T value = T();
+    sqlite3_get_function_arg(arg,
+        static_cast<exchange_type>(exchange_traits<T>::x_type), &value);
+    return value;
+}
+
+template <typename T>
+void sqlite3_function_result(sqlite_api::sqlite3_context *ctx, T const &value)
+{
+    static_assert(std::is_same<typename exchange_traits<T>::type_family,
+                               basic_type_tag>::value,
+                  "Only basic types can be used with SQLite functions");
+
+    sqlite3_set_function_result(ctx,
+        static_cast<exchange_type>(exchange_traits<T>::x_type), &value);
+}
+
+template <typename Signature>
+struct sqlite3_function;
+
+// Callbacks used for the functions with the given signature, F is the type
+// of the scalar function object and A the class implementing the aggregate.
+template <typename R, typename... Args>
+struct sqlite3_function<R(Args...)>
+{
+    enum { arity = sizeof...(Args) };
+
+    template <typename F>
+    static void call(sqlite_api::sqlite3_context *ctx, int,
+                     sqlite_api::sqlite3_value **argv)
+    {
+        try
+        {
+            F &f = *static_cast<F *>(sqlite3_get_function_data(ctx));
+            call_impl(ctx, f, argv, std::index_sequence_for<Args...>());
+        }
+        catch (std::exception const &e)
+        {
+            sqlite3_set_function_error(ctx, e.what());
+        }
+        catch (...)
+        {
+            // Exceptions must not propagate through SQLite C code.
+            sqlite3_set_function_error(ctx, "unknown C++ exception");
+        }
+    }
+
+    template <typename A>
+    static void step(sqlite_api::sqlite3_context *ctx, int,
+                     sqlite_api::sqlite3_value **argv)
+    {
+        try
+        {
+            void **state = sqlite3_get_aggregate_state(ctx, true);
+            if (!*state)
+                *state = new A();
+
+            step_impl(*static_cast<A *>(*state), argv,
+                      std::index_sequence_for<Args...>());
+        }
+        catch (std::exception const &e)
+        {
+            sqlite3_set_function_error(ctx, e.what());
+        }
+        catch (...)
+        {
+            sqlite3_set_function_error(ctx, "unknown C++ exception");
+        }
+    }
+
+    template <typename A>
+    static void finish(sqlite_api::sqlite3_context *ctx)
+    {
+        try
+        {
+            // There is no state if there were no rows in the group.
+            void **state = sqlite3_get_aggregate_state(ctx, false);
+            std::unique_ptr<A> a(state ? static_cast<A *>(*state) : 0);
+            if (!a)
+                a.reset(new A());
+
+            sqlite3_function_result<R>(ctx, a->finalize());
+        }
+        catch (std::exception const &e)
+        {
+            sqlite3_set_function_error(ctx, e.what());
+        }
+        catch (...)
+        {
+            sqlite3_set_function_error(ctx, "unknown C++ exception");
+        }
+    }
+
+    template <typename T>
+    static void destroy(void *data)
+    {
+        delete static_cast<T *>(data);
+    }
+
+private:
+    template <typename F, std::size_t... I>
+    static void call_impl(sqlite_api::sqlite3_context *ctx, F &f,
+                          sqlite_api::sqlite3_value **argv,
+                          std::index_sequence<I...>)
+    {
+        (void)argv;
+        sqlite3_function_result<R>(ctx,
+            f(sqlite3_function_arg<typename std::decay<Args>::type>(argv[I])...));
+    }
+
+    template <typename A, std::size_t... I>
+    static void step_impl(A &a, sqlite_api::sqlite3_value **argv,
+                          std::index_sequence<I...>)
+    {
+        (void)argv;
+        a.step(sqlite3_function_arg<typename std::decay<Args>::type>(argv[I])...);
+    }
+};
+
+} // namespace details
+
+// Description of a read-only table whose data is stored in the vectors in
+// the application memory, one per column. It can be used as a normal table
+// in the SQL statements after registering it with
+// sqlite3_session_backend::create_memory_table(), without copying the data.
+class SOCI_SQLITE3_DECL sqlite3_memory_table
+{
+public:
+    // Add a column with the given name and the data stored in the vector,
+    // which must remain valid while the table is used. The vector may be
+    // modified between the queries using the table, but all of its columns
+    // must have the same number of elements. If the indicators vector is
+    // specified, the values with i_null indicators are returned as NULL.
+    template <typename T>
+    sqlite3_memory_table &add_column(std::string const &name,
+                                     std::vector<T> const &data,
+                                     std::vector<indicator> const *inds = 0)
+    {
+        static_assert(std::is_same<typename details::exchange_traits<T>::type_family,
+                                   details::basic_type_tag>::value,
+                      "Only basic types can be used in SQLite memory tables");
+
+        column c;
+        c.name_ = name;
+        c.type_ = static_cast<details::exchange_type>(
+                    details::exchange_traits<T>::x_type);
+        c.vector_ = &data;
+        c.get_data_ = &get_vector_data<T>;
+        c.get_size_ = &get_vector_size<T>;
+        c.inds_ = inds;
+        columns_.push_back(c);
+
+        return *this;
+    }
+
+    // Implementation only.
+    struct column
+    {
+        std::string name_;
+        details::exchange_type type_;
+        void const *vector_;
+        void const *(*get_data_)(void const *);
+        std::size_t (*get_size_)(void const *);
+        std::vector<indicator> const *inds_;
+    };
+
+    std::vector<column> const &columns() const { return columns_; }
+
+private:
+    template <typename T>
+    static void const *get_vector_data(void const *p)
+    {
+        return static_cast<std::vector<T> const *>(p)->data();
+    }
+
+    template <typename T>
+    static std::size_t get_vector_size(void const *p)
+    {
+        return static_cast<std::vector<T> const *>(p)->size();
+    }
+
+    std::vector<column> columns_;
 };
 
 struct sqlite3_session_backend : details::session_backend
@@ -299,6 +664,74 @@ struct sqlite3_session_backend : details::session_backend
 
     void clean_up();
 
+    // Helpers for working with the savepoints with the given name.
+    void savepoint(char const *name);
+    void release_savepoint(char const *name);
+    void rollback_to_savepoint(char const *name);
+
+    // Return the prepared statement for this query from the cache, removing
+    // it from there, or null if the cache doesn't contain it.
+    sqlite_api::sqlite3_stmt *take_cached_statement(std::string const &query);
+
+    // Put the statement which was prepared for the given query into the
+    // cache, or finalize it if the cache is disabled. If the cache is full,
+    // the least recently used statement in it is finalized.
+    void release_statement(std::string const &query,
+                           sqlite_api::sqlite3_stmt *stmt);
+
+    // Register a scalar function with the given signature, e.g. "int(int,
+    // std::string)", implemented by the given function object which can then
+    // be called from SQL statements using this connection. The argument and
+    // return types must be basic types supported by SOCI.
+    //
+    // Deterministic functions, i.e. always returning the same result for the
+    // same arguments, can be used in indices and optimized by SQLite.
+    template <typename Signature, typename F>
+    void create_function(std::string const &name, F func,
+                         bool deterministic = true)
+    {
+        typedef details::sqlite3_function<Signature> function;
+
+        register_function(name, function::arity, deterministic, new F(func),
+                          &function::template call<F>, 0, 0,
+                          &function::template destroy<F>);
+    }
+
+    // Register an aggregate function with the given signature, where the
+    // argument types are those of the values aggregated and the return type
+    // is the type of the result. The aggregate class must be default
+    // constructible and have step() method taking the arguments and
+    // finalize() method returning the result. A new object is created for
+    // each group of rows.
+    template <typename Signature, typename Aggregate>
+    void create_aggregate(std::string const &name, bool deterministic = true)
+    {
+        typedef details::sqlite3_function<Signature> function;
+
+        register_function(name, function::arity, deterministic, 0, 0,
+                          &function::template step<Aggregate>,
+                          &function::template finish<Aggregate>, 0);
+    }
+
+    // Remove the function previously registered with the given name and
+    // number of arguments.
+    SOCI_SQLITE3_DECL void remove_function(std::string const &name, int arity);
+
+    // Replace the contents of the main database of this connection with the
+    // contents of the given database file or save it to this file, replacing
+    // its current contents. This is typically used with in-memory databases.
+    SOCI_SQLITE3_DECL void load_from(std::string const &filename);
+    SOCI_SQLITE3_DECL void save_to(std::string const &filename);
+
+    // Make the table with the data stored in memory available under the
+    // given name, which must not be used by any other table. The table
+    // description is copied, but the data is not. Requires SQLite 3.9.0.
+    SOCI_SQLITE3_DECL void create_memory_table(std::string const &name,
+                                               sqlite3_memory_table const &table);
+
+    // Remove the table previously created by create_memory_table().
+    SOCI_SQLITE3_DECL void drop_memory_table(std::string const &name);
+
     sqlite3_statement_backend * make_statement_backend() override;
     sqlite3_rowid_backend * make_rowid_backend() override;
     sqlite3_blob_backend * make_blob_backend() override;
@@ -349,6 +782,38 @@ struct sqlite3_session_backend : details::session_backend
     // This flag is set to true if the internal sqlite_sequence table exists in
     // the database.
     bool sequence_table_exists_;
+
+    // Default number of rows committed at once by bulk operations executed
+    // outside of a transaction, 0 if they are not batched at all.
+    int bulkBatchSize_;
+
+private:
+    // Wrapper for sqlite3_create_function_v2() throwing on error. The user
+    // data is destroyed using the provided function even if it fails.
+    SOCI_SQLITE3_DECL void register_function(std::string const &name, int arity,
+        bool deterministic, void *userData,
+        void (*func)(sqlite_api::sqlite3_context *, int,
+                     sqlite_api::sqlite3_value **),
+        void (*step)(sqlite_api::sqlite3_context *, int,
+                     sqlite_api::sqlite3_value **),
+        void (*finish)(sqlite_api::sqlite3_context *),
+        void (*destroy)(void *));
+
+    // Prepared statements not currently used by any statement backend, the
+    // most recently used ones first, and the index for finding them by query.
+    typedef std::list<std::pair<std::string, sqlite_api::sqlite3_stmt *> >
+        cached_statements;
+    cached_statements statementCache_;
+    std::unordered_multimap<std::string, cached_statements::iterator>
+        statementCacheIndex_;
+
+    // Maximal number of statements in the cache, 0 if it's disabled.
+    std::size_t statementCacheSize_;
+
+    // The file to which the in-memory database is saved when closing the
+    // connection, empty if it is not saved, and the VFS used for it.
+    std::string saveOnCloseFile_;
+    std::string saveOnCloseVfs_;
 };
 
 struct sqlite3_backend_factory : backend_factory
@@ -360,6 +825,39 @@ struct sqlite3_backend_factory : backend_factory
 
 extern SOCI_SQLITE3_DECL sqlite3_backend_factory const sqlite3;
 
+// Pool of connections to the same SQLite database file using WAL journal
+// mode, which allows the readers to run concurrently with each other and
+// with the (single) writer.
+//
+// The pool contains one read-write connection and the given number of
+// read-only ones, use the session constructor taking connection_pool to
+// lease a connection from either for_write() or for_read() pools.
+class SOCI_SQLITE3_DECL sqlite3_wal_pool
+{
+public:
+    // The connection string is the same as for a normal SQLite session, but
+    // must refer to a file and not an in-memory database. If mmapSize is
+    // non-zero, it is used to set the mmap_size pragma for all connections.
+    sqlite3_wal_pool(std::string const &connectString, std::size_t readers,
+                     long long mmapSize = 0);
+
+    // Pool with the single read-write connection: leasing it blocks until
+    // any other writer gives it back.
+    connection_pool &for_write() { return writer_; }
+
+    // Pool of the read-only connections.
+    connection_pool &for_read() { return readers_; }
+
+    // Return the pool corresponding to the given intent.
+    connection_pool &get(bool write) { return write ? writer_ : readers_; }
+
+private:
+    connection_pool writer_;
+    connection_pool readers_;
+
+    SOCI_NOT_COPYABLE(sqlite3_wal_pool)
+};
+
 extern "C"
 {
 
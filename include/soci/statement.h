@@ -9,6 +9,7 @@
 #define SOCI_STATEMENT_H_INCLUDED
 
 #include "soci/bind-values.h"
+#include "soci/exchange-stats.h"
 #include "soci/into-type.h"
 #include "soci/into.h"
 #include "soci/noreturn.h"
@@ -18,6 +19,7 @@
 #include "soci/row.h"
 // std
 #include <cstddef>
+#include <exception>
 #include <string>
 #include <vector>
 
@@ -26,6 +28,7 @@ namespace soci
 
 class session;
 class values;
+class async_result;
 
 namespace details
 {
@@ -44,15 +47,17 @@ public:
     void alloc();
     void bind(values & v);
 
-    void exchange(into_type_ptr const & i) { intos_.exchange(i); }
+    void exchange(into_type_ptr const & i)
+    { intos_.exchange(i); planOutdated_ = true; }
     template <typename T, typename Indicator>
     void exchange(into_container<T, Indicator> const &ic)
-    { intos_.exchange(ic); }
+    { intos_.exchange(ic); planOutdated_ = true; }
 
-    void exchange(use_type_ptr const & u) { uses_.exchange(u); }
+    void exchange(use_type_ptr const & u)
+    { uses_.exchange(u); planOutdated_ = true; }
     template <typename T, typename Indicator>
     void exchange(use_container<T, Indicator> const &uc)
-    { uses_.exchange(uc); }
+    { uses_.exchange(uc); planOutdated_ = true; }
 
 
     void clean_up();
@@ -63,6 +68,7 @@ public:
     void define_and_bind();
     void undefine_and_bind();
     bool execute(bool withDataExchange = false);
+    async_result execute_async(bool withDataExchange = false);
     long long get_affected_rows();
     bool fetch();
     void describe();
@@ -76,6 +82,18 @@ public:
     // (downcast it to expected back-end statement class)
     statement_backend * get_backend() { return backEnd_; }
 
+    exchange_stats const & get_exchange_stats() const { return stats_; }
+    void reset_exchange_stats() { stats_ = exchange_stats(); }
+
+    // Check that the query returns the columns of the types compatible with
+    // the given exchange types when it is executed for the first time. The
+    // types array must remain valid until then.
+    void set_expected_columns(int const * types, std::size_t count)
+    {
+        expectedColumns_ = types;
+        expectedColumnsCount_ = count;
+    }
+
     standard_into_type_backend * make_into_type_backend();
     standard_use_type_backend * make_use_type_backend();
     vector_into_type_backend * make_vector_into_type_backend();
@@ -89,11 +107,16 @@ public:
     std::string rewrite_for_procedure_call(std::string const & query);
 
 protected:
+    // This must be declared before the elements allocated from it.
+    exchange_arena arena_;
+
     into_type_vector intos_;
     use_type_vector uses_;
     std::vector<indicator *> indicators_;
 
 private:
+    friend class soci::async_result;
+
     // Call this method from a catch clause (only!) to rethrow the exception
     // after adding the context in which it happened, including the provided
     // description of the operation that failed, the SQL query and, if
@@ -110,6 +133,32 @@ private:
     into_type_vector intosForRow_;
     int definePositionForRow_;
 
+    exchange_stats stats_;
+
+    // The exchange plan contains the information about the elements used by
+    // execute() and fetch(), which is only updated when the elements change.
+    //
+    // The into elements are flattened into a single list, in the order in
+    // which their hooks must be called, i.e. the elements injected by row
+    // description come first. This list is either intos_ itself, if there
+    // are no such elements, or intosWithRow_ otherwise.
+    std::vector<into_type_base *> const * intosPlan_;
+    std::vector<into_type_base *> intosWithRow_;
+    bool intosHaveVectors_;
+    bool usesHaveVectors_;
+
+    // Combination of statement_backend::exchange_hook values for the hooks
+    // which must be called.
+    int exchangeHooks_;
+
+    bool planOutdated_;
+
+    void update_exchange_plan();
+
+    // The types of the columns to check before the first execution, if any.
+    int const * expectedColumns_;
+    std::size_t expectedColumnsCount_;
+
     template <typename Into>
     void exchange_for_rowset_(Into const &i)
     {
@@ -119,6 +168,7 @@ private:
         }
 
         intos_.exchange(i);
+        planOutdated_ = true;
 
         int definePosition = 1;
         for(into_type_vector::iterator iter = intos_.begin(),
@@ -131,24 +181,47 @@ private:
 
     template <typename T, typename Indicator>
     void exchange_for_row(into_container<T, Indicator> const &ic)
-    { intosForRow_.exchange(ic); }
-    void exchange_for_row(into_type_ptr const & i) { intosForRow_.exchange(i); }
+    { intosForRow_.exchange(ic); planOutdated_ = true; }
+    void exchange_for_row(into_type_ptr const & i)
+    { intosForRow_.exchange(i); planOutdated_ = true; }
     void define_for_row();
 
+    // Make the exchange() functions allocate the elements from arena_.
+    void set_exchange_arena();
+
     template<typename T>
-    void into_row()
+    void into_row(std::size_t pos)
     {
-        T * t = new T();
-        indicator * ind = new indicator(i_ok);
-        row_->add_holder(t, ind);
-        exchange_for_row(into(*t, *ind));
+        exchange_for_row(into(row_->values_[pos].template get<T>(),
+                              row_->indicators_[pos]));
     }
 
     template<data_type>
-    void bind_into();
+    void bind_into(std::size_t pos);
 
     bool alreadyDescribed_;
 
+    // execute() and execute_async() helpers: the first one does everything
+    // before executing the statement and returns the number of rows to
+    // exchange and the second one processes the result of the execution.
+    int start_execute(bool withDataExchange);
+    bool finish_execute(statement_backend::exec_fetch_result res, int num);
+
+    // Execute the statement after calling start_execute().
+    bool execute_sync(int num);
+
+    // Throw if the statement is still being executed asynchronously.
+    void check_not_executing_async() const;
+
+    // async_result helpers.
+    bool poll_async_execute(bool wait);
+    bool complete_async_execute();
+    void cancel_async_execute();
+
+    // Number of rows exchanged by the asynchronous execution in progress,
+    // or -1 if there is none.
+    int asyncNum_;
+
     std::size_t intos_size();
     std::size_t uses_size();
     void pre_exec(int num);
@@ -166,6 +239,49 @@ private:
 
 } // namespace details
 
+// Object returned by statement::execute_async() allowing to check whether the
+// statement execution has completed, to wait for its completion or to cancel
+// it. The statement must not be used until then, but the object keeps it
+// alive, so it doesn't need to outlive this object.
+class SOCI_DECL async_result
+{
+public:
+    async_result(async_result && other) noexcept;
+
+    // If the execution hasn't completed yet, cancel it and wait until it
+    // does, so that the statement can be used again.
+    ~async_result();
+
+    // Return true if the execution has completed, without blocking.
+    bool is_ready();
+
+    // Wait until the execution completes and return the same value as
+    // statement::execute() would have returned, or throw the same exception.
+    bool get();
+
+    // Cancel the execution, get() will throw if it hadn't completed yet.
+    void cancel();
+
+private:
+    friend class details::statement_impl;
+
+    // Create the object for the execution in progress or for the already
+    // completed one with the given result.
+    explicit async_result(details::statement_impl & st);
+    async_result(details::statement_impl & st, bool gotData,
+                 std::exception_ptr error);
+
+    // Called once the execution has completed to process its result.
+    void complete();
+
+    details::statement_impl * impl_;
+    bool done_;
+    bool gotData_;
+    std::exception_ptr error_;
+
+    SOCI_NOT_COPYABLE(async_result)
+};
+
 // Statement is a handle class for statement_impl
 // (this provides copyability to otherwise non-copyable type)
 class SOCI_DECL statement
@@ -217,6 +333,18 @@ public:
         return gotData_;
     }
 
+    // Start executing the statement without waiting for its completion, which
+    // allows a single thread to have several statements in progress at once,
+    // if the backend supports it (currently only ODBC does), or execute it
+    // synchronously otherwise. The values of the use elements are taken when
+    // this function is called, while the into elements are only filled once
+    // the execution completes. Notice that got_data() of this object is not
+    // updated in this case, use the value returned by async_result::get().
+    async_result execute_async(bool withDataExchange = false)
+    {
+        return impl_->execute_async(withDataExchange);
+    }
+
     long long get_affected_rows()
     {
         return impl_->get_affected_rows();
@@ -251,6 +379,23 @@ public:
         return impl_->get_backend();
     }
 
+    // Return the work done by all execute() and fetch() calls of this
+    // statement since its creation or the last reset_exchange_stats() call.
+    //
+    // Only available if SOCI was built with SOCI_INSTRUMENTATION option.
+    exchange_stats const & get_exchange_stats() const
+    {
+        return impl_->get_exchange_stats();
+    }
+
+    void reset_exchange_stats() { impl_->reset_exchange_stats(); }
+
+    // This is used by typed_statement and is not part of the public API.
+    void set_expected_columns(int const * types, std::size_t count)
+    {
+        impl_->set_expected_columns(types, count);
+    }
+
     details::standard_into_type_backend * make_into_type_backend()
     {
         return impl_->make_into_type_backend();
@@ -9,9 +9,15 @@
 #define SOCI_TYPE_HOLDER_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/soci-backend.h"
 // std
 #include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+#include <type_traits>
 #include <typeinfo>
+#include <utility>
 
 namespace soci
 {
@@ -44,49 +50,244 @@ T* checked_ptr_cast(U* ptr)
     return static_cast<T*>(ptr);
 }
 
-// Base class holder + derived class type_holder for storing type data
-// instances in a container of holder objects
+// Maps the types used for storing the values of the dynamically described
+// columns to the data_type of the column, or -1 for all the other types.
 template <typename T>
-class type_holder;
+struct row_value_traits
+{
+    static int const type = -1;
+};
+
+template <>
+struct row_value_traits<std::string>
+{
+    static int const type = dt_string;
+};
+
+template <>
+struct row_value_traits<double>
+{
+    static int const type = dt_double;
+};
+
+template <>
+struct row_value_traits<int>
+{
+    static int const type = dt_integer;
+};
+
+template <>
+struct row_value_traits<long long>
+{
+    static int const type = dt_long_long;
+};
+
+template <>
+struct row_value_traits<unsigned long long>
+{
+    static int const type = dt_unsigned_long_long;
+};
+
+template <>
+struct row_value_traits<std::tm>
+{
+    static int const type = dt_date;
+};
 
-class holder
+// Holds a single value of one of the types supported by row_value_traits.
+//
+// This is a tagged union indexed by data_type: the type of the value is
+// selected at run-time, but accessing it only requires comparing the tag with
+// the compile-time constant for the requested type, without any virtual
+// calls or RTTI.
+class value_holder
 {
 public:
-    holder() {}
-    virtual ~holder() {}
+    // Create a holder with the default value of the type used for storing the
+    // values of the given type, i.e. BLOB and XML values are stored as strings.
+    explicit value_holder(data_type type)
+        : type_(get_storage_type(type))
+    {
+        switch (type_)
+        {
+            case dt_string:
+                new (&string_) std::string();
+                break;
+            case dt_date:
+                tm_ = std::tm();
+                break;
+            case dt_double:
+                double_ = 0;
+                break;
+            case dt_integer:
+                integer_ = 0;
+                break;
+            case dt_long_long:
+                long_long_ = 0;
+                break;
+            case dt_unsigned_long_long:
+                unsigned_long_long_ = 0;
+                break;
+            case dt_blob:
+            case dt_xml:
+                // Not used as storage types.
+                break;
+        }
+    }
 
-    template<typename T>
-    T get()
+    // Create a holder with a copy of the given value.
+    template <typename T,
+              typename = typename std::enable_if<
+                  row_value_traits<T>::type != -1>::type>
+    explicit value_holder(T const& value)
+        : type_(static_cast<data_type>(row_value_traits<T>::type))
     {
-        type_holder<T>* p = checked_ptr_cast<type_holder<T> >(this);
-        if (p)
+        new (&member(static_cast<T*>(NULL))) T(value);
+    }
+
+    value_holder(value_holder const& other)
+        : type_(other.type_)
+    {
+        copy_from(other);
+    }
+
+    value_holder& operator=(value_holder const& other)
+    {
+        if (this != &other)
         {
-            return p->template value<T>();
+            destroy();
+            type_ = other.type_;
+            copy_from(other);
         }
-        else
+
+        return *this;
+    }
+
+    ~value_holder()
+    {
+        destroy();
+    }
+
+    data_type get_type() const { return type_; }
+
+    // Return true if the value is of the given type.
+    template <typename T>
+    bool holds() const
+    {
+        return row_value_traits<T>::type == static_cast<int>(type_);
+    }
+
+    // Return the value, which must be of the given type, throws
+    // std::bad_cast otherwise.
+    template <typename T>
+    T& get()
+    {
+        return do_get<T>(std::integral_constant<bool,
+                         row_value_traits<T>::type != -1>());
+    }
+
+    template <typename T>
+    T const& get() const
+    {
+        return const_cast<value_holder*>(this)->get<T>();
+    }
+
+private:
+    static data_type get_storage_type(data_type type)
+    {
+        switch (type)
+        {
+            case dt_blob:
+            case dt_xml:
+                return dt_string;
+
+            case dt_string:
+            case dt_date:
+            case dt_double:
+            case dt_integer:
+            case dt_long_long:
+            case dt_unsigned_long_long:
+                break;
+        }
+
+        return type;
+    }
+
+    template <typename T>
+    T& do_get(std::true_type /* supported type */)
+    {
+        if (!holds<T>())
         {
             throw std::bad_cast();
         }
+
+        return member(static_cast<T*>(NULL));
     }
 
-private:
+    template <typename T>
+    T& do_get(std::false_type /* supported type */)
+    {
+        // Values of the other types are never stored here.
+        throw std::bad_cast();
+    }
 
-    template<typename T>
-    T value();
-};
+    // Overloads selecting the union member by its type.
+    std::string& member(std::string*) { return string_; }
+    std::tm& member(std::tm*) { return tm_; }
+    double& member(double*) { return double_; }
+    int& member(int*) { return integer_; }
+    long long& member(long long*) { return long_long_; }
+    unsigned long long& member(unsigned long long*) { return unsigned_long_long_; }
 
-template <typename T>
-class type_holder : public holder
-{
-public:
-    type_holder(T * t) : t_(t) {}
-    ~type_holder() override { delete t_; }
+    void copy_from(value_holder const& other)
+    {
+        switch (type_)
+        {
+            case dt_string:
+                new (&string_) std::string(other.string_);
+                break;
+            case dt_date:
+                tm_ = other.tm_;
+                break;
+            case dt_double:
+                double_ = other.double_;
+                break;
+            case dt_integer:
+                integer_ = other.integer_;
+                break;
+            case dt_long_long:
+                long_long_ = other.long_long_;
+                break;
+            case dt_unsigned_long_long:
+                unsigned_long_long_ = other.unsigned_long_long_;
+                break;
+            case dt_blob:
+            case dt_xml:
+                break;
+        }
+    }
 
-    template<typename TypeValue>
-    TypeValue value() const { return *t_; }
+    void destroy()
+    {
+        // Only strings need to be destroyed, all the other types are trivial.
+        if (type_ == dt_string)
+        {
+            typedef std::string string_type;
+            string_.~string_type();
+        }
+    }
 
-private:
-    T * t_;
+    data_type type_;
+
+    union
+    {
+        std::string string_;
+        std::tm tm_;
+        double double_;
+        int integer_;
+        long long long_long_;
+        unsigned long long unsigned_long_long_;
+    };
 };
 
 } // namespace details
@@ -0,0 +1,175 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_TYPED_STATEMENT_H_INCLUDED
+#define SOCI_TYPED_STATEMENT_H_INCLUDED
+
+#include "soci/soci-platform.h"
+#include "soci/exchange-traits.h"
+#include "soci/into.h"
+#include "soci/prepare-temp-type.h"
+#include "soci/session.h"
+#include "soci/statement.h"
+#include "soci/use.h"
+// std
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Returns the exchange type used for the column of the given type if it can
+// be checked against the column description or -1 if it can't, e.g. for the
+// user-defined types.
+template <typename T, typename Family = typename exchange_traits<T>::type_family>
+struct typed_column_traits
+{
+    static int const x_type = -1;
+};
+
+template <typename T>
+struct typed_column_traits<T, basic_type_tag>
+{
+    static int const x_type = exchange_traits<T>::x_type;
+};
+
+// Check that the statement returns the given number of columns of the types
+// compatible with the given exchange types and throw if it doesn't.
+SOCI_DECL void check_typed_columns(statement_backend & backEnd,
+    int const * types, std::size_t count);
+
+} // namespace details
+
+template <typename Columns, typename Params = std::tuple<> >
+class typed_statement;
+
+// Statement with the types of the columns it returns and of the parameters it
+// uses known at compile-time.
+//
+// This is a convenience wrapper around a prepared statement: the into and use
+// elements for all of them are created once, when the statement is prepared,
+// and the column types are checked when it is executed for the first time.
+// The values are exchanged using the same elements as with the normal into()
+// and use(), so this is not faster than a prepared statement using them, but
+// it is more convenient and type-safe.
+template <typename... Columns, typename... Params>
+class typed_statement<std::tuple<Columns...>, std::tuple<Params...> >
+{
+    static_assert(sizeof...(Columns) > 0,
+                  "Typed statement must have at least one column.");
+
+public:
+    typedef std::tuple<Columns...> row_type;
+    typedef std::tuple<Params...> params_type;
+
+    typed_statement(session & sql, std::string const & query)
+        : row_(), params_(),
+          indicators_{ ((void)sizeof(Columns), i_null)... },
+          st_(prepare(sql, query,
+                      std::index_sequence_for<Columns...>(),
+                      std::index_sequence_for<Params...>()))
+    {
+        static int const types[] =
+            { details::typed_column_traits<Columns>::x_type... };
+
+        // The columns can't be checked before the parameters are bound, as
+        // some backends need to execute the query to describe it.
+        st_.set_expected_columns(types, sizeof...(Columns));
+    }
+
+    // Execute the statement with the given parameters and fetch the first
+    // row, return false if there are no rows. Throws if the columns returned
+    // by the query don't match the typed statement columns.
+    bool execute(Params const &... params)
+    {
+        params_ = params_type(params...);
+
+        return st_.execute(true);
+    }
+
+    // Fetch the next row, return false if there are no more rows.
+    bool fetch() { return st_.fetch(); }
+
+    bool got_data() const { return st_.got_data(); }
+
+    // Return the values of the last fetched row.
+    row_type const & get_row() const { return row_; }
+
+    template <std::size_t I>
+    typename std::tuple_element<I, row_type>::type const & get() const
+    {
+        return std::get<I>(row_);
+    }
+
+    indicator get_indicator(std::size_t pos) const
+    {
+        if (pos >= sizeof...(Columns))
+        {
+            throw std::out_of_range("Typed statement column index is out of range");
+        }
+
+        return indicators_[pos];
+    }
+
+    // Return the object of the given type initialized with the values of the
+    // last fetched row, which is typically a structure with the fields of
+    // the same types as the columns.
+    template <typename T>
+    T get_as() const
+    {
+        return get_as<T>(std::index_sequence_for<Columns...>());
+    }
+
+    // Return the underlying statement, e.g. to get its exchange statistics.
+    statement & get_statement() { return st_; }
+
+private:
+    template <std::size_t... I, std::size_t... J>
+    details::prepare_temp_type prepare(session & sql,
+                                       std::string const & query,
+                                       std::index_sequence<I...>,
+                                       std::index_sequence<J...>)
+    {
+        details::prepare_temp_type prep = (sql.prepare << query);
+
+        int const intos[] =
+            { ((void)(prep, into(std::get<I>(row_), indicators_[I])), 0)... };
+        int const uses[] =
+            { 0, ((void)(prep, use(std::get<J>(params_))), 0)... };
+
+        SOCI_UNUSED(intos);
+        SOCI_UNUSED(uses);
+
+        return prep;
+    }
+
+    template <typename T, std::size_t... I>
+    T get_as(std::index_sequence<I...>) const
+    {
+        return T{std::get<I>(row_)...};
+    }
+
+    // The values are declared before the statement using them. The
+    // indicators are i_null until the first row is fetched.
+    row_type row_;
+    params_type params_;
+    indicator indicators_[sizeof...(Columns)];
+
+    statement st_;
+
+    SOCI_NOT_COPYABLE(typed_statement)
+};
+
+} // namespace soci
+
+#endif // SOCI_TYPED_STATEMENT_H_INCLUDED
@@ -11,6 +11,7 @@
 #include "soci/soci-platform.h"
 #include "soci/soci-backend.h"
 #include "soci/type-ptr.h"
+#include "soci/exchange-arena.h"
 #include "soci/exchange-traits.h"
 // std
 #include <cstddef>
@@ -29,6 +30,13 @@ class SOCI_DECL use_type_base
 public:
     virtual ~use_type_base() {}
 
+    // Elements are allocated from the arena of the statement using them, if
+    // possible, see exchange_arena.
+    static void * operator new(std::size_t size)
+    { return exchange_arena::allocate_object(size); }
+    static void operator delete(void * p)
+    { exchange_arena::deallocate_object(p); }
+
     virtual void bind(statement_impl & st, int & position) = 0;
     virtual std::string get_name() const = 0;
     virtual void dump_value(std::ostream& os) const = 0;
@@ -38,6 +46,13 @@ public:
     virtual void clean_up() = 0;
 
     virtual std::size_t size() const = 0;  // returns the number of elements
+
+    // Only vectors can have size different from 1.
+    virtual bool is_vector() const { return false; }
+
+    // Return false if pre_exec() doesn't do anything except forwarding to the
+    // backend element, see into_type_base::has_own_hooks().
+    virtual bool has_own_hooks() const { return true; }
 };
 
 typedef type_ptr<use_type_base> use_type_ptr;
@@ -88,6 +103,7 @@ protected:
 
 private:
     void pre_exec(int num) override;
+    bool has_own_hooks() const override { return false; }
     void post_use(bool gotData) override;
     void clean_up() override;
     std::size_t size() const override { return 1; }
@@ -159,10 +175,12 @@ private:
     std::string get_name() const override { return name_; }
     void dump_value(std::ostream& os) const override;
     void pre_exec(int num) override;
+    bool has_own_hooks() const override { return false; }
     void pre_use() override;
     void post_use(bool) override { /* nothing to do */ }
     void clean_up() override;
     std::size_t size() const override;
+    bool is_vector() const override { return true; }
 
     void* data_;
     exchange_type type_;
@@ -81,6 +81,7 @@ public:
     }
 
     void pre_exec(int /* num */) override {}
+    bool has_own_hooks() const override { return false; }
 
     void post_use(bool /*gotData*/) override
     {
@@ -11,11 +11,15 @@
 #include "soci/statement.h"
 #include "soci/into-type.h"
 #include "soci/use-type.h"
+#include "soci/type-holder.h"
 // std
 #include <cstddef>
+#include <deque>
 #include <map>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -25,6 +29,7 @@ namespace soci
 namespace details
 {
 
+// Copies of the values of types which can't be stored in value_holder.
 class copy_base
 {
 public:
@@ -39,6 +44,13 @@ struct copy_holder : public copy_base
     T value_;
 };
 
+// Used for selecting the storage of the copies of the values at compile-time.
+template <typename T>
+struct is_value_holder_type
+    : std::integral_constant<bool, row_value_traits<T>::type != -1>
+{
+};
+
 } // namespace details
 
 class SOCI_DECL values
@@ -176,12 +188,11 @@ public:
             base_type baseValue{};
             type_conversion<T>::to_base(value, baseValue, *pind);
 
-            details::copy_holder<base_type> * pcopy =
-                    new details::copy_holder<base_type>(baseValue);
-            deepCopies_.push_back(pcopy);
+            base_type & copy = add_copy(baseValue,
+                details::is_value_holder_type<base_type>());
 
             uses_.push_back(new details::use_type<base_type>(
-                    pcopy->value_, *pind, name));
+                    copy, *pind, name));
         }
         else
         {
@@ -191,7 +202,8 @@ public:
             {
                 type_conversion<T>::to_base(
                         value,
-                        static_cast<details::copy_holder<base_type>*>(deepCopies_[index])->value_,
+                        get_copy<base_type>(index,
+                            details::is_value_holder_type<base_type>()),
                         *indicators_[index]);
             }
         }
@@ -207,12 +219,10 @@ public:
         base_type baseValue;
         type_conversion<T>::to_base(value, baseValue, *pind);
 
-        details::copy_holder<base_type> * pcopy =
-            new details::copy_holder<base_type>(baseValue);
-        deepCopies_.push_back(pcopy);
+        base_type & copy = add_copy(baseValue,
+            details::is_value_holder_type<base_type>());
 
-        uses_.push_back(new details::use_type<base_type>(
-                pcopy->value_, *pind));
+        uses_.push_back(new details::use_type<base_type>(copy, *pind));
     }
 
     template <typename T>
@@ -244,6 +254,15 @@ private:
     std::map<details::use_type_base *, indicator *> unused_;
     std::vector<indicator *> indicators_;
     std::map<std::string, std::size_t> index_;
+
+    // Copies of the values passed to set(). The values of the types supported
+    // by value_holder are stored in heldValues_, which doesn't invalidate the
+    // references to its elements when adding new ones, and the pointers to
+    // them are in holders_, while the values of all the other types are in
+    // deepCopies_. Both vectors are indexed by position and contain null
+    // pointers for the values stored in the other one.
+    std::deque<details::value_holder> heldValues_;
+    std::vector<details::value_holder *> holders_;
     std::vector<details::copy_base *> deepCopies_;
 
     mutable std::size_t currentPos_;
@@ -283,17 +302,15 @@ private:
     template <typename T>
     T get_from_uses(std::size_t pos) const
     {
-        details::standard_use_type* u = uses_[pos];
-
         typedef typename type_conversion<T>::base_type base_type;
 
-        if (details::checked_ptr_cast<details::use_type<base_type> >(u))
+        base_type const * baseValue = find_copy<base_type>(pos,
+            details::is_value_holder_type<base_type>());
+        if (baseValue)
         {
-            base_type const & baseValue = *static_cast<base_type*>(u->get_data());
-
             T val;
             indicator ind = *indicators_[pos];
-            type_conversion<T>::from_base(baseValue, ind, val);
+            type_conversion<T>::from_base(*baseValue, ind, val);
             return val;
         }
         else
@@ -307,6 +324,77 @@ private:
         }
     }
 
+    // Store a copy of the value and return a reference to it, which remains
+    // valid until clean_up() is called.
+    template <typename T>
+    T & add_copy(T const & value, std::true_type /* is value_holder type */)
+    {
+        heldValues_.emplace_back(value);
+
+        details::value_holder & holder = heldValues_.back();
+        holders_.push_back(&holder);
+        deepCopies_.push_back(NULL);
+
+        return holder.get<T>();
+    }
+
+    template <typename T>
+    T & add_copy(T const & value, std::false_type /* is value_holder type */)
+    {
+        details::copy_holder<T> * pcopy = new details::copy_holder<T>(value);
+        holders_.push_back(NULL);
+        deepCopies_.push_back(pcopy);
+
+        return pcopy->value_;
+    }
+
+    // Return the copy of the value at the given position, which must have
+    // been stored by add_copy() for the same type.
+    template <typename T>
+    T & get_copy(std::size_t pos, std::true_type /* is value_holder type */)
+    {
+        if (!holders_[pos])
+        {
+            throw std::bad_cast();
+        }
+
+        return holders_[pos]->get<T>();
+    }
+
+    template <typename T>
+    T & get_copy(std::size_t pos, std::false_type /* is value_holder type */)
+    {
+        return static_cast<details::copy_holder<T>*>(deepCopies_[pos])->value_;
+    }
+
+    // Return the pointer to the copy of the value at the given position if it
+    // is of the given type or null otherwise.
+    template <typename T>
+    T const * find_copy(std::size_t pos,
+                        std::true_type /* is value_holder type */) const
+    {
+        details::value_holder const * holder = holders_[pos];
+        if (!holder || !holder->holds<T>())
+        {
+            return NULL;
+        }
+
+        return &holder->get<T>();
+    }
+
+    template <typename T>
+    T const * find_copy(std::size_t pos,
+                        std::false_type /* is value_holder type */) const
+    {
+        details::standard_use_type * u = uses_[pos];
+        if (!details::checked_ptr_cast<details::use_type<T> >(u))
+        {
+            return NULL;
+        }
+
+        return static_cast<T const *>(u->get_data());
+    }
+
     row& get_row()
     {
         row_ = new row();
@@ -343,6 +431,10 @@ private:
         {
             delete deepCopies_[i];
         }
+
+        deepCopies_.clear();
+        holders_.clear();
+        heldValues_.clear();
     }
 };
 
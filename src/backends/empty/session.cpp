@@ -7,6 +7,11 @@
 
 #define SOCI_EMPTY_SOURCE
 #include "soci/empty/soci-empty.h"
+#include "soci/connection-parameters.h"
+
+#include <chrono>
+#include <sstream>
+#include <thread>
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
@@ -15,11 +20,119 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // anonymous
+{
+
+data_type parse_column_type(std::string const & name)
+{
+    if (name == "string")
+        return dt_string;
+    if (name == "date")
+        return dt_date;
+    if (name == "double")
+        return dt_double;
+    if (name == "int" || name == "integer")
+        return dt_integer;
+    if (name == "long_long")
+        return dt_long_long;
+    if (name == "unsigned_long_long")
+        return dt_unsigned_long_long;
+    if (name == "blob")
+        return dt_blob;
+    if (name == "xml")
+        return dt_xml;
+
+    throw soci_error("Unknown column type \"" + name + "\" in empty backend "
+                     "connection string.");
+}
+
+template <typename T>
+T parse_number(std::string const & key, std::string const & val)
+{
+    std::istringstream converter(val);
+    T value;
+    if (!(converter >> value) || !converter.eof())
+    {
+        throw soci_error("Invalid value \"" + val + "\" of the \"" + key +
+                         "\" option in empty backend connection string.");
+    }
+
+    return value;
+}
+
+} // namespace anonymous
+
+void empty_session_options::parse(std::string const & connectString)
+{
+    std::istringstream ssconn(connectString);
+    std::string option;
+    while (ssconn >> option)
+    {
+        std::string::size_type const pos = option.find('=');
+        if (pos == std::string::npos)
+        {
+            // Allow arbitrary strings without any options for compatibility.
+            continue;
+        }
+
+        std::string const key = option.substr(0, pos);
+        std::string const val = option.substr(pos + 1);
+
+        if (key == "rows")
+        {
+            rows_ = parse_number<int>(key, val);
+            if (rows_ < 0)
+                throw soci_error("Number of rows can't be negative.");
+        }
+        else if (key == "columns")
+        {
+            columns_.clear();
+
+            std::istringstream sscols(val);
+            std::string column;
+            while (std::getline(sscols, column, ','))
+            {
+                columns_.push_back(parse_column_type(column));
+            }
+        }
+        else if (key == "string_length")
+        {
+            stringLength_ = parse_number<std::size_t>(key, val);
+        }
+        else if (key == "null_ratio")
+        {
+            nullRatio_ = parse_number<double>(key, val);
+            if (nullRatio_ < 0 || nullRatio_ > 1)
+                throw soci_error("Null ratio must be between 0 and 1.");
+        }
+        else if (key == "latency_us")
+        {
+            latencyMicroseconds_ = parse_number<long>(key, val);
+        }
+        else
+        {
+            throw soci_error("Unknown option \"" + key + "\" in empty "
+                             "backend connection string.");
+        }
+    }
+
+    // Use a single column by default if any data is generated.
+    if (generates_data() && columns_.empty())
+    {
+        columns_.push_back(dt_integer);
+    }
+}
 
 empty_session_backend::empty_session_backend(
-    connection_parameters const & /* parameters */)
+    connection_parameters const & parameters)
 {
-    // ...
+    options_.parse(parameters.get_connect_string());
+
+    stringValue_.reserve(options_.stringLength_);
+    for (std::size_t i = 0; i != options_.stringLength_; ++i)
+    {
+        stringValue_ += static_cast<char>('a' + i % 26);
+    }
 }
 
 empty_session_backend::~empty_session_backend()
@@ -47,6 +160,15 @@ void empty_session_backend::clean_up()
     // ...
 }
 
+void empty_session_backend::simulate_latency() const
+{
+    if (options_.latencyMicroseconds_ > 0)
+    {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(options_.latencyMicroseconds_));
+    }
+}
+
 empty_statement_backend * empty_session_backend::make_statement_backend()
 {
     return new empty_statement_backend(*this);
@@ -17,9 +17,11 @@ using namespace soci::details;
 
 
 void empty_standard_into_type_backend::define_by_pos(
-    int & /* position */, void * /* data */, exchange_type /* type */)
+    int & position, void * data, exchange_type type)
 {
-    // ...
+    data_ = data;
+    type_ = type;
+    position_ = position++;
 }
 
 void empty_standard_into_type_backend::pre_fetch()
@@ -28,9 +30,34 @@ void empty_standard_into_type_backend::pre_fetch()
 }
 
 void empty_standard_into_type_backend::post_fetch(
-    bool /* gotData */, bool /* calledFromFetch */, indicator * /* ind */)
+    bool gotData, bool /* calledFromFetch */, indicator * ind)
 {
-    // ...
+    if (!gotData || !statement_.session_.options_.generates_data())
+    {
+        return;
+    }
+
+    int const row = statement_.firstRowInBatch_;
+    int const column = position_ - 1;
+
+    if (statement_.is_null_value(row, column))
+    {
+        if (ind == NULL)
+        {
+            throw soci_error(
+                "Null value fetched and no indicator defined.");
+        }
+
+        *ind = i_null;
+        return;
+    }
+
+    statement_.generate_value(row, column, type_, data_);
+
+    if (ind != NULL)
+    {
+        *ind = i_ok;
+    }
 }
 
 void empty_standard_into_type_backend::clean_up()
@@ -17,10 +17,10 @@ using namespace soci::details;
 
 
 void empty_standard_use_type_backend::bind_by_pos(
-    int & /* position */, void * /* data */,
+    int & position, void * /* data */,
     exchange_type /* type */, bool /* readOnly */)
 {
-    // ...
+    ++position;
 }
 
 void empty_standard_use_type_backend::bind_by_name(
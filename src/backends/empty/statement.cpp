@@ -7,6 +7,13 @@
 
 #define SOCI_EMPTY_SOURCE
 #include "soci/empty/soci-empty.h"
+#include "soci/exchange-stats.h"
+#include "soci-exchange-cast.h"
+#include "soci-vector-helpers.h"
+
+#include <cmath>
+#include <ctime>
+#include <sstream>
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
@@ -15,9 +22,94 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // anonymous
+{
+
+// Synthetic value of a single cell, converted to the type of the variable by
+// the overloads of assign() below.
+struct synthetic_value
+{
+    synthetic_value(long long number, std::string const & str)
+        : number_(number), str_(str) {}
+
+    long long number_;
+    std::string const & str_;
+
+private:
+    SOCI_NOT_COPYABLE(synthetic_value)
+};
+
+void assign(char & var, synthetic_value const & v)
+{
+    var = v.str_.empty() ? '\0' : v.str_[0];
+}
+
+void assign(std::string & var, synthetic_value const & v)
+{
+    var = v.str_;
+    count_bytes_copied(v.str_.size());
+}
+
+void assign(short & var, synthetic_value const & v)
+{
+    var = static_cast<short>(v.number_);
+}
+
+void assign(int & var, synthetic_value const & v)
+{
+    var = static_cast<int>(v.number_);
+}
+
+void assign(long long & var, synthetic_value const & v)
+{
+    var = v.number_;
+}
+
+void assign(unsigned long long & var, synthetic_value const & v)
+{
+    var = static_cast<unsigned long long>(v.number_);
+}
+
+void assign(double & var, synthetic_value const & v)
+{
+    var = static_cast<double>(v.number_) + 0.5;
+}
+
+void assign(std::tm & var, synthetic_value const & v)
+{
+    var = std::tm();
+    var.tm_year = 100;
+    var.tm_mon = static_cast<int>(v.number_ % 12);
+    var.tm_mday = static_cast<int>(1 + v.number_ % 28);
+    var.tm_hour = static_cast<int>(v.number_ % 24);
+    var.tm_min = static_cast<int>(v.number_ % 60);
+    var.tm_sec = static_cast<int>(v.number_ % 60);
+}
+
+void assign(long_string & var, synthetic_value const & v)
+{
+    var.value = v.str_;
+    count_bytes_copied(v.str_.size());
+}
+
+void assign(xml_type & var, synthetic_value const & v)
+{
+    var.value = v.str_;
+    count_bytes_copied(v.str_.size());
+}
+
+void throw_unsupported_type(int column)
+{
+    std::ostringstream ss;
+    ss << "Unsupported type of column " << column + 1 << " in empty backend.";
+    throw soci_error(ss.str());
+}
+
+} // namespace anonymous
 
 empty_statement_backend::empty_statement_backend(empty_session_backend &session)
-    : session_(session)
+    : session_(session),
+      nextRow_(0), firstRowInBatch_(0), rowsInBatch_(0), affectedRows_(-1)
 {
 }
 
@@ -38,29 +130,57 @@ void empty_statement_backend::prepare(std::string const & /* query */,
 }
 
 statement_backend::exec_fetch_result
-empty_statement_backend::execute(int /* number */)
+empty_statement_backend::execute(int number)
 {
-    // ...
-    return ef_success;
+    session_.simulate_latency();
+
+    if (!session_.options_.generates_data())
+    {
+        return ef_success;
+    }
+
+    affectedRows_ = number;
+
+    nextRow_ = 0;
+    firstRowInBatch_ = 0;
+    rowsInBatch_ = 0;
+
+    return number > 0 ? load_rows(number) : ef_success;
 }
 
 statement_backend::exec_fetch_result
-empty_statement_backend::fetch(int /* number */)
+empty_statement_backend::fetch(int number)
 {
-    // ...
-    return ef_success;
+    session_.simulate_latency();
+
+    if (!session_.options_.generates_data())
+    {
+        return ef_success;
+    }
+
+    return load_rows(number);
+}
+
+statement_backend::exec_fetch_result
+empty_statement_backend::load_rows(int number)
+{
+    int const available = session_.options_.rows_ - nextRow_;
+
+    firstRowInBatch_ = nextRow_;
+    rowsInBatch_ = number < available ? number : available;
+    nextRow_ += rowsInBatch_;
+
+    return rowsInBatch_ == number ? ef_success : ef_no_data;
 }
 
 long long empty_statement_backend::get_affected_rows()
 {
-    // ...
-    return -1;
+    return affectedRows_;
 }
 
 int empty_statement_backend::get_number_of_rows()
 {
-    // ...
-    return 1;
+    return session_.options_.generates_data() ? rowsInBatch_ : 1;
 }
 
 std::string empty_statement_backend::get_parameter_name(int /* index */) const
@@ -77,14 +197,118 @@ std::string empty_statement_backend::rewrite_for_procedure_call(
 
 int empty_statement_backend::prepare_for_describe()
 {
-    // ...
-    return 0;
+    return static_cast<int>(session_.options_.columns_.size());
 }
 
-void empty_statement_backend::describe_column(int /* colNum */,
-    data_type & /* type */, std::string & /* columnName */)
+void empty_statement_backend::describe_column(int colNum,
+    data_type & type, std::string & columnName)
 {
-    // ...
+    type = session_.options_.columns_.at(colNum - 1);
+
+    std::ostringstream ss;
+    ss << "col" << colNum;
+    columnName = ss.str();
+}
+
+bool empty_statement_backend::is_null_value(int row, int column) const
+{
+    // Spread the nulls uniformly, shifting them in every column.
+    double const ratio = session_.options_.nullRatio_;
+    double const n = row + column;
+
+    return std::floor((n + 1) * ratio) > std::floor(n * ratio);
+}
+
+void empty_statement_backend::generate_value(int row, int column,
+    exchange_type type, void * data) const
+{
+    synthetic_value const v(row + 1, session_.stringValue_);
+
+    switch (type)
+    {
+        case x_char:
+            assign(exchange_type_cast<x_char>(data), v);
+            break;
+        case x_stdstring:
+            assign(exchange_type_cast<x_stdstring>(data), v);
+            break;
+        case x_short:
+            assign(exchange_type_cast<x_short>(data), v);
+            break;
+        case x_integer:
+            assign(exchange_type_cast<x_integer>(data), v);
+            break;
+        case x_long_long:
+            assign(exchange_type_cast<x_long_long>(data), v);
+            break;
+        case x_unsigned_long_long:
+            assign(exchange_type_cast<x_unsigned_long_long>(data), v);
+            break;
+        case x_double:
+            assign(exchange_type_cast<x_double>(data), v);
+            break;
+        case x_stdtm:
+            assign(exchange_type_cast<x_stdtm>(data), v);
+            break;
+        case x_longstring:
+            assign(exchange_type_cast<x_longstring>(data), v);
+            break;
+        case x_xmltype:
+            assign(exchange_type_cast<x_xmltype>(data), v);
+            break;
+
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            throw_unsupported_type(column);
+            break;
+    }
+}
+
+void empty_statement_backend::generate_vector_value(int row, int column,
+    exchange_type type, void * data, std::size_t index) const
+{
+    synthetic_value const v(row + 1, session_.stringValue_);
+
+    switch (type)
+    {
+        case x_char:
+            assign(exchange_vector_type_cast<x_char>(data)[index], v);
+            break;
+        case x_stdstring:
+            assign(exchange_vector_type_cast<x_stdstring>(data)[index], v);
+            break;
+        case x_short:
+            assign(exchange_vector_type_cast<x_short>(data)[index], v);
+            break;
+        case x_integer:
+            assign(exchange_vector_type_cast<x_integer>(data)[index], v);
+            break;
+        case x_long_long:
+            assign(exchange_vector_type_cast<x_long_long>(data)[index], v);
+            break;
+        case x_unsigned_long_long:
+            assign(exchange_vector_type_cast<x_unsigned_long_long>(data)[index], v);
+            break;
+        case x_double:
+            assign(exchange_vector_type_cast<x_double>(data)[index], v);
+            break;
+        case x_stdtm:
+            assign(exchange_vector_type_cast<x_stdtm>(data)[index], v);
+            break;
+        case x_longstring:
+            assign(exchange_vector_type_cast<x_longstring>(data)[index], v);
+            break;
+        case x_xmltype:
+            assign(exchange_vector_type_cast<x_xmltype>(data)[index], v);
+            break;
+
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            throw_unsupported_type(column);
+            break;
+    }
 }
 
 empty_standard_into_type_backend * empty_statement_backend::make_into_type_backend()
@@ -7,15 +7,18 @@
 
 #define SOCI_EMPTY_SOURCE
 #include "soci/empty/soci-empty.h"
+#include "soci-vector-helpers.h"
 
 using namespace soci;
 using namespace soci::details;
 
 
 void empty_vector_into_type_backend::define_by_pos(
-    int & /* position */, void * /* data */, exchange_type /* type */)
+    int & position, void * data, exchange_type type)
 {
-    // ...
+    data_ = data;
+    type_ = type;
+    position_ = position++;
 }
 
 void empty_vector_into_type_backend::pre_fetch()
@@ -23,21 +26,47 @@ void empty_vector_into_type_backend::pre_fetch()
     // ...
 }
 
-void empty_vector_into_type_backend::post_fetch(
-    bool /* gotData */, indicator * /* ind */)
+void empty_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
 {
-    // ...
+    if (!gotData || !statement_.session_.options_.generates_data())
+    {
+        return;
+    }
+
+    int const column = position_ - 1;
+    int const rows = statement_.rowsInBatch_;
+    for (int i = 0; i != rows; ++i)
+    {
+        int const row = statement_.firstRowInBatch_ + i;
+        if (statement_.is_null_value(row, column))
+        {
+            if (ind == NULL)
+            {
+                throw soci_error(
+                    "Null value fetched and no indicator defined.");
+            }
+
+            ind[i] = i_null;
+            continue;
+        }
+
+        statement_.generate_vector_value(row, column, type_, data_, i);
+
+        if (ind != NULL)
+        {
+            ind[i] = i_ok;
+        }
+    }
 }
 
-void empty_vector_into_type_backend::resize(std::size_t /* sz */)
+void empty_vector_into_type_backend::resize(std::size_t sz)
 {
-    // ...
+    resize_vector(type_, data_, sz);
 }
 
 std::size_t empty_vector_into_type_backend::size()
 {
-    // ...
-    return 1;
+    return get_vector_size(type_, data_);
 }
 
 void empty_vector_into_type_backend::clean_up()
@@ -14,19 +14,34 @@ using namespace soci::details::firebird;
 
 firebird_blob_backend::firebird_blob_backend(firebird_session_backend &session)
 	  : session_(session), bid_(), from_db_(false), bhp_(0), data_(),
-		loaded_(false), max_seg_size_(0)
+		loaded_(false), max_seg_size_(0), len_(0), readPos_(0), writing_(false)
 {}
 
 firebird_blob_backend::~firebird_blob_backend()
 {
-    cleanUp();
+    // Errors can't be reported from here and are not interesting anyhow, as
+    // the blob is being discarded. They can happen if the transaction in which
+    // it was being written or read has already ended, for example.
+    try
+    {
+        cleanUp();
+    }
+    catch (...)
+    {
+    }
 }
 
 std::size_t firebird_blob_backend::get_len()
 {
-    if (from_db_ && bhp_ == 0)
+    if (writing_)
+    {
+        return len_;
+    }
+
+    if (from_db_ && (loaded_ == false))
     {
         open();
+        return len_;
     }
 
     return data_.size();
@@ -34,10 +49,33 @@ std::size_t firebird_blob_backend::get_len()
 
 std::size_t firebird_blob_backend::read_from_start(char * buf, std::size_t toRead, std::size_t offset)
 {
+    if (writing_)
+    {
+        // the data written so far must be stored in the database to be read
+        finishWriting();
+    }
+
     if (from_db_ && (loaded_ == false))
     {
-        // this is blob fetched from database, but not loaded yet
-        load();
+        // this is blob fetched from database, stream its segments instead
+        // of loading all of them
+        open();
+
+        if (offset > len_)
+        {
+            throw soci_error("Can't read past-the-end of BLOB data");
+        }
+
+        if (offset < readPos_)
+        {
+            // segmented BLOBs can't be read backwards, start again
+            close();
+            open();
+        }
+
+        readSegments(NULL, offset - readPos_);
+
+        return readSegments(buf, len_ - offset < toRead ? len_ - offset : toRead);
     }
 
     std::size_t size = data_.size();
@@ -63,6 +101,19 @@ std::size_t firebird_blob_backend::read_from_start(char * buf, std::size_t toRea
 
 std::size_t firebird_blob_backend::write_from_start(char const * buf, std::size_t toWrite, std::size_t offset)
 {
+    if (isStreamingWrite(offset))
+    {
+        writeSegments(buf, toWrite);
+
+        return toWrite;
+    }
+
+    if (writing_)
+    {
+        // this is not a sequential write, so we need the data in memory
+        finishWriting();
+    }
+
     if (from_db_ && (loaded_ == false))
     {
         // this is blob fetched from database, but not loaded yet
@@ -90,6 +141,13 @@ std::size_t firebird_blob_backend::write_from_start(char const * buf, std::size_
 std::size_t firebird_blob_backend::append(
     char const * buf, std::size_t toWrite)
 {
+    if (isStreamingWrite(writing_ ? len_ : 0))
+    {
+        writeSegments(buf, toWrite);
+
+        return toWrite;
+    }
+
     if (from_db_ && (loaded_ == false))
     {
         // this is blob fetched from database, but not loaded yet
@@ -106,6 +164,23 @@ std::size_t firebird_blob_backend::append(
 
 void firebird_blob_backend::trim(std::size_t newLen)
 {
+    if (newLen == 0)
+    {
+        // no need to load anything, just start with a new empty blob
+        cleanUp();
+        return;
+    }
+
+    if (writing_)
+    {
+        if (newLen == len_)
+        {
+            return;
+        }
+
+        finishWriting();
+    }
+
     if (from_db_ && (loaded_ == false))
     {
         // this is blob fetched from database, but not loaded yet
@@ -127,6 +202,17 @@ void firebird_blob_backend::writeBuffer(std::size_t offset,
     }
 }
 
+bool firebird_blob_backend::isStreamingWrite(std::size_t offset) const
+{
+    // New blobs written sequentially are sent to the database directly.
+    if (writing_)
+    {
+        return offset == len_;
+    }
+
+    return !from_db_ && data_.empty() && offset == 0;
+}
+
 void firebird_blob_backend::open()
 {
     if (bhp_ != 0)
@@ -145,9 +231,23 @@ void firebird_blob_backend::open()
     }
 
     // get basic blob info
-    long blob_size = getBLOBInfo();
+    len_ = static_cast<std::size_t>(getBLOBInfo());
+    readPos_ = 0;
+}
+
+void firebird_blob_backend::close()
+{
+    if (bhp_ != 0)
+    {
+        ISC_STATUS stat[20];
+        if (isc_close_blob(stat, &bhp_))
+        {
+            throw_iscerror(stat);
+        }
+        bhp_ = 0;
+    }
 
-    data_.resize(blob_size);
+    readPos_ = 0;
 }
 
 void firebird_blob_backend::cleanUp()
@@ -156,63 +256,85 @@ void firebird_blob_backend::cleanUp()
     loaded_ = false;
     max_seg_size_ = 0;
     data_.resize(0);
+    len_ = 0;
 
-    if (bhp_ != 0)
+    if (writing_)
     {
-        // close blob
+        // discard the blob which was never saved
+        writing_ = false;
+
         ISC_STATUS stat[20];
-        if (isc_close_blob(stat, &bhp_))
+        if (isc_cancel_blob(stat, &bhp_))
         {
             throw_iscerror(stat);
         }
         bhp_ = 0;
     }
+
+    close();
 }
 
 // loads blob data into internal buffer
 void firebird_blob_backend::load()
 {
-    if (bhp_ == 0)
+    if (readPos_ != 0)
     {
-        open();
+        // some data was already streamed, start again
+        close();
     }
 
+    open();
+
+    data_.resize(len_);
+
     // The blob is empty.
     if (data_.empty())
     {
+        loaded_ = true;
         return;
     }
 
+    // data_ is large-enough because we know total size of blob, but the
+    // blob may still turn out to be shorter than expected
+    data_.resize(readSegments(&data_[0], data_.size()));
+
+    loaded_ = true;
+}
+
+// reads the next segments of the opened blob into the provided buffer or just
+// skips them if the buffer is NULL, returns the number of bytes read which
+// is less than requested only if the end of the blob was reached
+std::size_t firebird_blob_backend::readSegments(char * buf, std::size_t toRead)
+{
     ISC_STATUS stat[20];
-    unsigned short bytes;
-    std::vector<char>::size_type total_bytes = 0;
-    bool keep_reading = false;
+    char skipBuf[4096];
+    std::size_t total_bytes = 0;
 
-    do
+    while (total_bytes < toRead)
     {
-        bytes = 0;
-        // next segment of data
-        // data_ is large-enough because we know total size of blob
-        isc_get_segment(stat, &bhp_, &bytes, static_cast<short>(max_seg_size_),
-                        &data_[total_bytes]);
+        std::size_t chunk = toRead - total_bytes;
+        if (buf == NULL && chunk > sizeof(skipBuf))
+            chunk = sizeof(skipBuf);
+        else if (chunk > 0xFFFF)
+            chunk = 0xFFFF;
+
+        unsigned short bytes = 0;
+        isc_get_segment(stat, &bhp_, &bytes, static_cast<unsigned short>(chunk),
+                        buf ? buf + total_bytes : skipBuf);
 
         total_bytes += bytes;
+        readPos_ += bytes;
 
-        if (total_bytes == data_.size())
-        {
-            // we have all BLOB data
-            keep_reading = false;
-        }
-        else if (stat[1] == 0 || stat[1] == isc_segment)
+        if (stat[1] == 0 || stat[1] == isc_segment)
         {
-            // there is more data to read from current segment (0)
-            // or there is next segment (isc_segment)
-            keep_reading = true;
+            // there is more data to read from current segment (isc_segment)
+            // or there is next segment (0)
+            continue;
         }
         else if (stat[1] == isc_segstr_eof)
         {
             // BLOB is shorter then we expected ???
-            keep_reading = false;
+            break;
         }
         else
         {
@@ -220,57 +342,85 @@ void firebird_blob_backend::load()
             throw_iscerror(stat);
         }
     }
-    while (keep_reading);
 
-    loaded_ = true;
+    return total_bytes;
 }
 
-// this method saves BLOB content to database
-// (a new BLOB will be created at this point)
-// BLOB will be closed after save.
-void firebird_blob_backend::save()
+// writes the data to the new blob, creating it if necessary
+void firebird_blob_backend::writeSegments(char const * buf, std::size_t toWrite)
 {
-    // close old blob if necessary
     ISC_STATUS stat[20];
-    if (bhp_ != 0)
+
+    if (writing_ == false)
     {
-        if (isc_close_blob(stat, &bhp_))
+        // discard whatever we had before and create a new blob
+        cleanUp();
+
+        if (isc_create_blob(stat, &session_.dbhp_, session_.current_transaction(),
+                            &bhp_, &bid_))
         {
             throw_iscerror(stat);
         }
-        bhp_ = 0;
-    }
 
-    // create new blob
-    if (isc_create_blob(stat, &session_.dbhp_, session_.current_transaction(),
-                        &bhp_, &bid_))
-    {
-        throw_iscerror(stat);
+        writing_ = true;
     }
 
-    if (data_.size() > 0)
+    // Segment Size : Specifying the BLOB segment is throwback to times past, when applications for working
+    // with BLOB data were written in C(Embedded SQL) with the help of the gpre pre - compiler.
+    // Nowadays, it is effectively irrelevant.The segment size for BLOB data is determined by the client side and is usually larger than the data page size,
+    // in any case.
+    std::size_t offset = 0;
+    while (offset < toWrite)
     {
-        // write data
-        size_t size = data_.size();
-        size_t offset = 0;
-        // Segment Size : Specifying the BLOB segment is throwback to times past, when applications for working
-        // with BLOB data were written in C(Embedded SQL) with the help of the gpre pre - compiler.
-        // Nowadays, it is effectively irrelevant.The segment size for BLOB data is determined by the client side and is usually larger than the data page size,
-        // in any case.
-        do
+        unsigned short segmentSize = 0xFFFF; //last unsigned short number
+        if (toWrite - offset < segmentSize) //if content size is less than max segment size or last data segment is about to be written
+            segmentSize = static_cast<unsigned short>(toWrite - offset);
+        //write segment
+        if (isc_put_segment(stat, &bhp_, segmentSize, buf + offset))
         {
-            unsigned short segmentSize = 0xFFFF; //last unsigned short number
-            if (size - offset < segmentSize) //if content size is less than max segment size or last data segment is about to be written
-                segmentSize = static_cast<unsigned short>(size - offset);
-            //write segment
-            if (isc_put_segment(stat, &bhp_, segmentSize, &data_[0]+offset))
-            {
-                throw_iscerror(stat);
-            }
-            offset += segmentSize;
+            throw_iscerror(stat);
         }
-        while (offset < size);
+        offset += segmentSize;
+        len_ += segmentSize;
     }
+}
+
+// closes the blob being written, after which it can be read from the database
+void firebird_blob_backend::finishWriting()
+{
+    writing_ = false;
+
+    close();
+
+    from_db_ = true;
+    loaded_ = false;
+}
+
+// this method saves BLOB content to database
+// (a new BLOB will be created at this point unless it was already written
+// directly or wasn't modified at all)
+// BLOB will be closed after save.
+void firebird_blob_backend::save()
+{
+    if (writing_)
+    {
+        // all data was already written, just close the blob
+        finishWriting();
+    }
+    else if (from_db_ && (loaded_ == false))
+    {
+        // the blob wasn't modified, so its id can be reused
+        close();
+    }
+    else
+    {
+        // create new blob
+        std::vector<char> data;
+        data.swap(data_);
+        writeSegments(data.empty() ? NULL : &data[0], data.size());
+        finishWriting();
+    }
+
     cleanUp();
     from_db_ = true;
 }
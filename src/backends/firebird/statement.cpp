@@ -8,10 +8,16 @@
 #define SOCI_FIREBIRD_SOURCE
 #include "soci/firebird/soci-firebird.h"
 #include "firebird/error-firebird.h"
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <sstream>
 #include <iostream>
 
+#ifdef SOCI_FIREBIRD_HAS_BATCH
+#include <firebird/Interface.h>
+#endif
+
 using namespace soci;
 using namespace soci::details;
 using namespace soci::details::firebird;
@@ -370,6 +376,247 @@ namespace
     }
 }
 
+#ifdef SOCI_FIREBIRD_HAS_BATCH
+
+namespace
+{
+
+// Maximal size of the messages buffered by a batch before executing it, this
+// is the default buffer size used by Firebird.
+std::size_t const batch_buffer_size = 16*1024*1024;
+
+// Simple smart pointer for the reference-counted Firebird interfaces.
+template <typename T>
+class fb_interface_ptr
+{
+public:
+    explicit fb_interface_ptr(T* p = NULL) : p_(p) {}
+    ~fb_interface_ptr() { if (p_) p_->release(); }
+
+    T* get() const { return p_; }
+    T* operator->() const { return p_; }
+
+private:
+    T* p_;
+
+    SOCI_NOT_COPYABLE(fb_interface_ptr)
+};
+
+// And another one for the objects which are disposed instead.
+template <typename T>
+class fb_disposable_ptr
+{
+public:
+    explicit fb_disposable_ptr(T* p = NULL) : p_(p) {}
+    ~fb_disposable_ptr() { if (p_) p_->dispose(); }
+
+    T* get() const { return p_; }
+    T* operator->() const { return p_; }
+
+private:
+    T* p_;
+
+    SOCI_NOT_COPYABLE(fb_disposable_ptr)
+};
+
+bool has_error(Firebird::CheckStatusWrapper& status)
+{
+    return (status.getState() & Firebird::IStatus::STATE_ERRORS) != 0;
+}
+
+void throw_status_error(Firebird::IStatus* status)
+{
+    char msg[SOCI_FIREBIRD_ERRMSG];
+    fb_get_master_interface()->getUtilInterface()->formatStatus(msg,
+        sizeof(msg), status);
+
+    throw firebird_soci_error(msg, status->getErrors());
+}
+
+void check_status(Firebird::CheckStatusWrapper& status)
+{
+    if (has_error(status))
+    {
+        throw_status_error(&status);
+    }
+}
+
+} // namespace anonymous
+
+bool firebird_statement_backend::execute_batch(std::size_t rows)
+{
+    if (procedure_ || rows < 2)
+        return false;
+
+    std::size_t const usize = uses_.size();
+    for (std::size_t col = 0; col < usize; ++col)
+    {
+        // Blobs would need to be added to the batch separately, just use the
+        // row by row execution for them.
+        switch (static_cast<firebird_vector_use_type_backend*>(uses_[col])->type_)
+        {
+            case x_xmltype:
+            case x_longstring:
+                return false;
+
+            default:
+                break;
+        }
+    }
+
+    Firebird::IMaster* const master = fb_get_master_interface();
+    Firebird::CheckStatusWrapper status(master->getStatus());
+    fb_disposable_ptr<Firebird::CheckStatusWrapper> statusGuard(&status);
+
+    ISC_STATUS stat[stat_size];
+
+    // The statement was prepared using the legacy API, get its interface.
+    Firebird::IStatement* stmt = NULL;
+    if (fb_get_statement_interface(stat, &stmt, &stmtp_))
+        return false;
+    fb_interface_ptr<Firebird::IStatement> stmtGuard(stmt);
+
+    fb_interface_ptr<Firebird::IMessageMetadata>
+        meta(stmt->getInputMetadata(&status));
+    if (has_error(status))
+        return false;
+
+    // The messages are filled using the values in the input SQLDA, so its
+    // layout must correspond to the metadata.
+    unsigned const count = meta->getCount(&status);
+    if (has_error(status) || count != static_cast<unsigned>(sqlda2p_->sqld))
+        return false;
+
+    std::vector<unsigned> offsets(count);
+    std::vector<unsigned> nullOffsets(count);
+    std::vector<unsigned> lengths(count);
+    for (unsigned i = 0; i != count; ++i)
+    {
+        XSQLVAR const& var = sqlda2p_->sqlvar[i];
+        int const type = var.sqltype & ~1;
+        if ((meta->getType(&status, i) & ~1u) != static_cast<unsigned>(type) ||
+                meta->getLength(&status, i) != static_cast<unsigned>(var.sqllen))
+        {
+            return false;
+        }
+
+        offsets[i] = meta->getOffset(&status, i);
+        nullOffsets[i] = meta->getNullOffset(&status, i);
+        lengths[i] = var.sqllen;
+        if (type == SQL_VARYING)
+            lengths[i] += sizeof(short);
+    }
+
+    unsigned const msgLength = meta->getMessageLength(&status);
+    unsigned const alignedLength = meta->getAlignedLength(&status);
+    if (has_error(status))
+        return false;
+
+    // Ask for the number of rows affected by each message.
+    fb_disposable_ptr<Firebird::IXpbBuilder> pb(
+        master->getUtilInterface()->getXpbBuilder(&status,
+            Firebird::IXpbBuilder::BATCH, NULL, 0));
+    pb->insertInt(&status, Firebird::IBatch::TAG_RECORD_COUNTS, 1);
+    if (has_error(status))
+        return false;
+
+    // This fails if the server doesn't support batches.
+    fb_interface_ptr<Firebird::IBatch> batch(
+        stmt->createBatch(&status, meta.get(),
+                          pb->getBufferLength(&status),
+                          pb->getBuffer(&status)));
+    if (has_error(status))
+        return false;
+
+    Firebird::ITransaction* tra = NULL;
+    if (fb_get_transaction_interface(stat, &tra,
+                                     session_.current_transaction()))
+    {
+        throw_iscerror(stat);
+    }
+    fb_interface_ptr<Firebird::ITransaction> traGuard(tra);
+
+    std::vector<unsigned char> msg(msgLength);
+
+    std::size_t rowsPerBatch = batch_buffer_size / alignedLength;
+    if (rowsPerBatch == 0)
+        rowsPerBatch = 1;
+
+    long long rowsAffected = 0;
+    for (std::size_t begin = 0; begin < rows; begin += rowsPerBatch)
+    {
+        std::size_t const end = std::min(rows, begin + rowsPerBatch);
+        for (std::size_t row = begin; row != end; ++row)
+        {
+            for (std::size_t col = 0; col < usize; ++col)
+            {
+                static_cast<firebird_vector_use_type_backend*>(uses_[col])->exchangeData(row);
+            }
+
+            for (unsigned i = 0; i != count; ++i)
+            {
+                XSQLVAR const& var = sqlda2p_->sqlvar[i];
+
+                short const isNull = var.sqlind && *var.sqlind == -1 ? -1 : 0;
+                std::memcpy(&msg[nullOffsets[i]], &isNull, sizeof(short));
+                if (!isNull)
+                    std::memcpy(&msg[offsets[i]], var.sqldata, lengths[i]);
+            }
+
+            batch->add(&status, 1, &msg[0]);
+            if (has_error(status))
+            {
+                rowsAffectedBulk_ = rowsAffected;
+                throw_status_error(&status);
+            }
+        }
+
+        fb_disposable_ptr<Firebird::IBatchCompletionState>
+            cs(batch->execute(&status, tra));
+        if (has_error(status))
+        {
+            rowsAffectedBulk_ = rowsAffected;
+            throw_status_error(&status);
+        }
+
+        // Without TAG_MULTIERROR the batch stops at the first error, so all
+        // the rows before it have been executed successfully.
+        unsigned const size = cs->getSize(&status);
+        for (unsigned i = 0; i != size; ++i)
+        {
+            int const state = cs->getState(&status, i);
+            if (state > 0)
+                rowsAffected += state;
+        }
+
+        unsigned const pos = cs->findError(&status, 0);
+        if (pos != Firebird::IBatchCompletionState::NO_MORE_ERRORS)
+        {
+            rowsAffectedBulk_ = rowsAffected;
+
+            Firebird::CheckStatusWrapper error(master->getStatus());
+            fb_disposable_ptr<Firebird::CheckStatusWrapper> errorGuard(&error);
+            cs->getStatus(&status, &error, pos);
+            check_status(status);
+            throw_status_error(&error);
+        }
+        check_status(status);
+    }
+
+    rowsAffectedBulk_ = rowsAffected;
+
+    return true;
+}
+
+#else // !SOCI_FIREBIRD_HAS_BATCH
+
+bool firebird_statement_backend::execute_batch(std::size_t /* rows */)
+{
+    return false;
+}
+
+#endif // SOCI_FIREBIRD_HAS_BATCH
+
 statement_backend::exec_fetch_result
 firebird_statement_backend::execute(int number)
 {
@@ -407,7 +654,12 @@ firebird_statement_backend::execute(int number)
         }
     }
 
-    if (useType_ == eVector)
+    if (useType_ == eVector && execute_batch(
+            static_cast<firebird_vector_use_type_backend*>(uses_[0])->size()))
+    {
+        // All rows were sent to the server in a single batch.
+    }
+    else if (useType_ == eVector)
     {
         long long rowsAffectedBulkTemp = 0;
 
@@ -18,10 +18,14 @@ using namespace soci;
 using namespace soci::details;
 
 char const * soci::odbc_option_driver_complete = "odbc.driver_complete";
+char const * soci::odbc_option_row_wise_binding = "odbc.row_wise_binding";
 
 odbc_session_backend::odbc_session_backend(
     connection_parameters const & parameters)
-    : henv_(0), hdbc_(0), product_(prod_uninitialized)
+    : henv_(0), hdbc_(0), rowWiseBinding_(false),
+      product_(prod_uninitialized),
+      getDataExtensions_(0), getDataExtensionsValid_(false),
+      asyncMode_(-1)
 {
     SQLRETURN rc;
 
@@ -47,6 +51,8 @@ odbc_session_backend::odbc_session_backend(
                               "allocating connection handle");
     }
 
+    rowWiseBinding_ = parameters.is_option_on(odbc_option_row_wise_binding);
+
     SQLCHAR outConnString[1024];
     SQLSMALLINT strLength = 0;
 
@@ -479,3 +485,40 @@ odbc_session_backend::get_database_product() const
 
     return product_;
 }
+
+SQLUINTEGER odbc_session_backend::get_data_extensions() const
+{
+    if (getDataExtensionsValid_)
+        return getDataExtensions_;
+
+    SQLRETURN rc = SQLGetInfo(hdbc_, SQL_GETDATA_EXTENSIONS,
+                              &getDataExtensions_, sizeof(getDataExtensions_),
+                              NULL);
+    if (is_odbc_error(rc))
+    {
+        // Assume the minimal support guaranteed by the ODBC specification.
+        getDataExtensions_ = 0;
+    }
+
+    getDataExtensionsValid_ = true;
+
+    return getDataExtensions_;
+}
+
+bool odbc_session_backend::supports_async_execution() const
+{
+    if (asyncMode_ == -1)
+    {
+        SQLUINTEGER mode = SQL_AM_NONE;
+        SQLRETURN rc = SQLGetInfo(hdbc_, SQL_ASYNC_MODE,
+                                  &mode, sizeof(mode), NULL);
+        if (is_odbc_error(rc))
+            mode = SQL_AM_NONE;
+
+        // We only enable asynchronous execution for individual statements, so
+        // connection-level support is not enough.
+        asyncMode_ = static_cast<int>(mode);
+    }
+
+    return asyncMode_ == SQL_AM_STATEMENT;
+}
@@ -8,8 +8,10 @@
 #define SOCI_ODBC_SOURCE
 #include "soci/odbc/soci-odbc.h"
 #include <cctype>
+#include <chrono>
 #include <sstream>
 #include <cstring>
+#include <thread>
 
 using namespace soci;
 using namespace soci::details;
@@ -18,7 +20,13 @@ using namespace soci::details;
 odbc_statement_backend::odbc_statement_backend(odbc_session_backend &session)
     : session_(session), hstmt_(0), numRowsFetched_(0), fetchVectorByRows_(false),
       hasVectorUseElements_(false), boundByName_(false), boundByPos_(false),
-      rowsAffected_(-1LL)
+      rowsAffected_(-1LL),
+      paramsProcessed_(0), asyncRc_(SQL_SUCCESS), asyncMode_(false),
+      asyncNumber_(0),
+#ifdef SOCI_ODBC_HAS_ASYNC_EVENT
+      asyncEvent_(NULL),
+#endif
+      rowWiseBinding_(session.rowWiseBinding_), boundRowWise_(false)
 {
 }
 
@@ -39,7 +47,21 @@ void odbc_statement_backend::clean_up()
 {
     rowsAffected_ = -1LL;
 
+    if (asyncRc_ == SQL_STILL_EXECUTING)
+    {
+        // Don't leave the execution running in the background.
+        SQLCancel(hstmt_);
+    }
+
     SQLFreeHandle(SQL_HANDLE_STMT, hstmt_);
+
+#ifdef SOCI_ODBC_HAS_ASYNC_EVENT
+    if (asyncEvent_)
+    {
+        CloseHandle(asyncEvent_);
+        asyncEvent_ = NULL;
+    }
+#endif
 }
 
 
@@ -137,21 +159,181 @@ void odbc_statement_backend::prepare(std::string const & query,
     intos_.clear();
 }
 
-statement_backend::exec_fetch_result
-odbc_statement_backend::execute(int number)
+void odbc_statement_backend::prepare_execute()
 {
     // Store the number of rows processed by this call.
-    SQLULEN rows_processed = 0;
+    paramsProcessed_ = 0;
     if (hasVectorUseElements_)
     {
-        SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAMS_PROCESSED_PTR, &rows_processed, 0);
+        SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAMS_PROCESSED_PTR, &paramsProcessed_, 0);
     }
 
     // if we are called twice for the same statement we need to close the open
     // cursor or an "invalid cursor state" error will occur on execute
     SQLCloseCursor(hstmt_);
+}
+
+void odbc_statement_backend::check_not_executing() const
+{
+    if (asyncRc_ == SQL_STILL_EXECUTING)
+    {
+        throw soci_error("Statement is still being executed asynchronously.");
+    }
+}
+
+statement_backend::exec_fetch_result
+odbc_statement_backend::execute(int number)
+{
+    check_not_executing();
+
+    prepare_execute();
+
+    return complete_execute(SQLExecute(hstmt_), number);
+}
+
+bool odbc_statement_backend::start_async_execute(int number)
+{
+    check_not_executing();
+
+    if (!session_.supports_async_execution())
+        return false;
+
+    prepare_execute();
+
+    SQLRETURN rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ASYNC_ENABLE,
+                                  (SQLPOINTER)SQL_ASYNC_ENABLE_ON, 0);
+    if (is_odbc_error(rc))
+    {
+        throw odbc_soci_error(SQL_HANDLE_STMT, hstmt_,
+                              "enabling asynchronous execution");
+    }
+
+    asyncMode_ = true;
+
+#ifdef SOCI_ODBC_HAS_ASYNC_EVENT
+    // Use notifications if the driver manager supports them, otherwise just
+    // fall back to polling.
+    if (!asyncEvent_)
+    {
+        HANDLE const event = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (event)
+        {
+            rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ASYNC_STMT_EVENT,
+                                event, SQL_IS_POINTER);
+            if (is_odbc_error(rc))
+                CloseHandle(event);
+            else
+                asyncEvent_ = event;
+        }
+    }
+#endif
+
+    asyncNumber_ = number;
+    asyncRc_ = SQLExecute(hstmt_);
+
+    return true;
+}
+
+bool odbc_statement_backend::poll_async_execute(bool wait)
+{
+    while (asyncRc_ == SQL_STILL_EXECUTING)
+    {
+#ifdef SOCI_ODBC_HAS_ASYNC_EVENT
+        if (asyncEvent_)
+        {
+            if (WaitForSingleObject(asyncEvent_, wait ? INFINITE : 0)
+                    != WAIT_OBJECT_0)
+            {
+                return false;
+            }
+
+            // With notifications, the result must be retrieved using this
+            // function instead of calling SQLExecute() again.
+            RETCODE rcAsync = SQL_ERROR;
+            SQLRETURN rc = SQLCompleteAsync(SQL_HANDLE_STMT, hstmt_, &rcAsync);
+            asyncRc_ = is_odbc_error(rc) ? rc : rcAsync;
+            break;
+        }
+#endif
+
+        // Without notifications, the same function must be called again to
+        // check if it has completed.
+        asyncRc_ = SQLExecute(hstmt_);
+        if (asyncRc_ != SQL_STILL_EXECUTING)
+            break;
+
+        if (!wait)
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+void odbc_statement_backend::end_async_mode()
+{
+    if (!asyncMode_)
+        return;
+
+    asyncMode_ = false;
+
+    // Subsequent operations, e.g. fetching, are synchronous.
+    SQLRETURN rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ASYNC_ENABLE,
+                                  (SQLPOINTER)SQL_ASYNC_ENABLE_OFF, 0);
+    if (is_odbc_error(rc))
+    {
+        throw odbc_soci_error(SQL_HANDLE_STMT, hstmt_,
+                              "disabling asynchronous execution");
+    }
+}
+
+statement_backend::exec_fetch_result
+odbc_statement_backend::complete_async_execute()
+{
+    SQLRETURN const rc = asyncRc_;
+    asyncRc_ = SQL_SUCCESS;
+
+    int const number = asyncNumber_;
+
+    if (!is_odbc_error(rc))
+    {
+        end_async_mode();
+
+        return complete_execute(rc, number);
+    }
+
+    // Process the error before leaving asynchronous mode to avoid losing its
+    // message, complete_execute() always throws in this case.
+    try
+    {
+        return complete_execute(rc, number);
+    }
+    catch (...)
+    {
+        asyncMode_ = false;
+        SQLSetStmtAttr(hstmt_, SQL_ATTR_ASYNC_ENABLE,
+                       (SQLPOINTER)SQL_ASYNC_ENABLE_OFF, 0);
+        throw;
+    }
+}
+
+void odbc_statement_backend::cancel_async_execute()
+{
+    if (asyncRc_ != SQL_STILL_EXECUTING)
+        return;
+
+    SQLRETURN rc = SQLCancel(hstmt_);
+    if (is_odbc_error(rc))
+    {
+        throw odbc_soci_error(SQL_HANDLE_STMT, hstmt_,
+                              "cancelling statement execution");
+    }
+}
 
-    SQLRETURN rc = SQLExecute(hstmt_);
+statement_backend::exec_fetch_result
+odbc_statement_backend::complete_execute(SQLRETURN rc, int number)
+{
     if (is_odbc_error(rc))
     {
         // Construct the error object immediately, before calling any other
@@ -179,17 +361,17 @@ odbc_statement_backend::execute(int number)
                   else
                     rowsAffected_ += res;
                 }
-                --rows_processed; // Avoid unnecessary calls to SQLGetDiagField
+                --paramsProcessed_; // Avoid unnecessary calls to SQLGetDiagField
             }
             // Move forward to the next result while there are rows processed.
-            while (rows_processed > 0 && SQLMoreResults(hstmt_) == SQL_SUCCESS);
+            while (paramsProcessed_ > 0 && SQLMoreResults(hstmt_) == SQL_SUCCESS);
         }
         throw err;
     }
     else if (hasVectorUseElements_)
     {
         // We already have the number of rows, no need to do anything.
-        rowsAffected_ = rows_processed;
+        rowsAffected_ = paramsProcessed_;
     }
     else // We need to retrieve the number of rows affected explicitly.
     {
@@ -231,15 +413,153 @@ odbc_statement_backend::do_fetch(int beginRow, int endRow)
 
     for (std::size_t j = 0; j != intos_.size(); ++j)
     {
-        intos_[j]->do_post_fetch_rows(beginRow, endRow);
+        if (boundRowWise_)
+            intos_[j]->do_post_fetch_row_wise(numRowsFetched_);
+        else
+            intos_[j]->do_post_fetch_rows(beginRow, endRow);
+    }
+
+    if (!longIntos_.empty())
+    {
+        if (endRow - beginRow == 1)
+        {
+            // There is only one row in the rowset, no need to position.
+            for (std::size_t j = 0; j != longIntos_.size(); ++j)
+            {
+                longIntos_[j]->get_long_value(beginRow);
+            }
+        }
+        else
+        {
+            for (SQLULEN row = 0; row != numRowsFetched_; ++row)
+            {
+                rc = SQLSetPos(hstmt_, row + 1, SQL_POSITION, SQL_LOCK_NO_CHANGE);
+                if (is_odbc_error(rc))
+                {
+                    throw odbc_soci_error(SQL_HANDLE_STMT, hstmt_,
+                                          "positioning cursor in the rowset");
+                }
+
+                for (std::size_t j = 0; j != longIntos_.size(); ++j)
+                {
+                    longIntos_[j]->get_long_value(beginRow + row);
+                }
+            }
+        }
     }
 
     return ef_success;
 }
 
+std::size_t odbc_statement_backend::bind_row_wise(int number)
+{
+    // Each value is followed by its indicator, align all of them suitably
+    // for the biggest types used.
+    std::size_t const alignment = sizeof(double) > sizeof(SQLLEN)
+                                    ? sizeof(double)
+                                    : sizeof(SQLLEN);
+
+    std::vector<std::size_t> valueOffsets(intos_.size());
+    std::vector<std::size_t> indOffsets(intos_.size());
+    std::size_t rowSize = 0;
+    for (std::size_t i = 0; i != intos_.size(); ++i)
+    {
+        std::size_t const size = intos_[i]->get_row_element_size();
+
+        valueOffsets[i] = rowSize;
+        rowSize += (size + alignment - 1) / alignment * alignment;
+
+        indOffsets[i] = rowSize;
+        rowSize += alignment;
+    }
+
+    // The buffer may be reallocated, so always rebind the columns.
+    rowBuf_.resize(rowSize * static_cast<std::size_t>(number));
+    for (std::size_t i = 0; i != intos_.size(); ++i)
+    {
+        intos_[i]->bind_row_wise(&rowBuf_[0], rowSize,
+                                 valueOffsets[i], indOffsets[i]);
+    }
+
+    return rowSize;
+}
+
+void odbc_statement_backend::unbind_row_wise()
+{
+    if (!boundRowWise_)
+        return;
+
+    for (std::size_t i = 0; i != intos_.size(); ++i)
+    {
+        intos_[i]->rebind_row(0);
+    }
+
+    boundRowWise_ = false;
+}
+
+void odbc_statement_backend::set_row_wise_binding(bool rowWise)
+{
+    rowWiseBinding_ = rowWise;
+
+    // The columns are bound row-wise again by the next fetch() if necessary,
+    // but must be bound back to the vectors if row-wise binding is disabled.
+    if (!rowWise)
+        unbind_row_wise();
+}
+
+void odbc_statement_backend::prepare_long_columns()
+{
+    longIntos_.clear();
+
+    int lastBoundPos = -1;
+    for (std::size_t i = 0; i != intos_.size(); ++i)
+    {
+        if (intos_[i]->longColumn_)
+            longIntos_.push_back(intos_[i]);
+        else if (intos_[i]->position_ > lastBoundPos)
+            lastBoundPos = intos_[i]->position_;
+    }
+
+    if (longIntos_.empty())
+        return;
+
+    // By default, SQLGetData() can only be used for the columns after the
+    // last bound one and in the increasing order.
+    SQLUINTEGER const ext = session_.get_data_extensions();
+    bool canGetData = true;
+    for (std::size_t i = 0; i != longIntos_.size(); ++i)
+    {
+        int const pos = longIntos_[i]->position_;
+        if (!(ext & SQL_GD_ANY_COLUMN) && pos < lastBoundPos)
+            canGetData = false;
+        if (!(ext & SQL_GD_ANY_ORDER) && i > 0 &&
+                pos < longIntos_[i - 1]->position_)
+            canGetData = false;
+    }
+
+    if (!canGetData)
+    {
+        for (std::size_t i = 0; i != longIntos_.size(); ++i)
+        {
+            longIntos_[i]->bind_long_column();
+        }
+
+        longIntos_.clear();
+        return;
+    }
+
+    // Using SQLGetData() for a rowset of more than one row requires its
+    // support for blocks, if it's not available, fetch the rows one by one
+    // (but, unlike with bind_long_column(), without using huge buffers).
+    if (!(ext & SQL_GD_BLOCK))
+        fetchVectorByRows_ = true;
+}
+
 statement_backend::exec_fetch_result
 odbc_statement_backend::fetch(int number)
 {
+    check_not_executing();
+
     numRowsFetched_ = 0;
 
     for (std::size_t i = 0; i != intos_.size(); ++i)
@@ -247,16 +567,34 @@ odbc_statement_backend::fetch(int number)
         intos_[i]->resize(number);
     }
 
-    SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_BIND_TYPE, SQL_BIND_BY_COLUMN, 0);
-
     statement_backend::exec_fetch_result res SOCI_DUMMY_INIT(ef_success);
 
-    // Usually we try to fetch the entire vector at once, but if some into
-    // string columns are bigger than 8KB (ODBC_MAX_COL_SIZE) then we use
-    // 100MB buffer for that columns. So in this case we downgrade to using
-    // scalar fetches to hold the buffer only for a single row and not
-    // rows_count * 100MB.
-    // See odbc_vector_into_type_backend::define_by_pos().
+    // String columns bigger than 8KB (ODBC_MAX_COL_SIZE) are not bound and
+    // their values are retrieved using SQLGetData() after fetching each
+    // rowset, see odbc_vector_into_type_backend::define_by_pos().
+    prepare_long_columns();
+
+    // Row-wise binding is only used with block fetches without SQLGetData().
+    if (rowWiseBinding_ && !intos_.empty() &&
+            longIntos_.empty() && !fetchVectorByRows_)
+    {
+        boundRowWise_ = true;
+    }
+    else
+    {
+        unbind_row_wise();
+    }
+
+    SQLULEN const bindType = boundRowWise_
+                                ? bind_row_wise(number)
+                                : SQL_BIND_BY_COLUMN;
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER)bindType, 0);
+
+    // Usually we try to fetch the entire vector at once, but if the driver
+    // doesn't support using SQLGetData() for the long columns with block
+    // cursors or for them at all, in which case we use 100MB buffer for
+    // those columns, we downgrade to using scalar fetches to hold the buffer
+    // only for a single row and not rows_count * 100MB.
     if (!fetchVectorByRows_)
     {
         SQLULEN row_array_size = static_cast<SQLULEN>(number);
@@ -268,6 +606,8 @@ odbc_statement_backend::fetch(int number)
     }
     else // Use multiple calls to SQLFetch().
     {
+        SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0);
+
         SQLULEN curNumRowsFetched = 0;
         SQLSetStmtAttr(hstmt_, SQL_ATTR_ROWS_FETCHED_PTR, &curNumRowsFetched, 0);
 
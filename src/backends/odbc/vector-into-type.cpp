@@ -95,13 +95,13 @@ void odbc_vector_into_type_backend::define_by_pos(
             colSize_ = static_cast<size_t>(get_sqllen_from_value(statement_.column_size(position)));
             if (colSize_ >= ODBC_MAX_COL_SIZE || colSize_ == 0)
             {
-                // Column size for text data type can be too large for buffer allocation.
-                colSize_ = odbc_max_buffer_length;
-                // If we are using huge buffer size then we need to fetch rows
-                // one by one as otherwise we could easily run out of memory.
-                // Note that the flag is permanent for the statement and will
-                // never be reset.
-                statement_.fetchVectorByRows_ = true;
+                // Column size for text data type can be too large for buffer
+                // allocation, so don't bind the column at all and retrieve
+                // its values in chunks using SQLGetData() instead, this
+                // allows the other columns to still be fetched in blocks.
+                // See odbc_statement_backend::fetch().
+                longColumn_ = true;
+                break;
             }
 
             colSize_++;
@@ -131,6 +131,10 @@ void odbc_vector_into_type_backend::define_by_pos(
 
 void odbc_vector_into_type_backend::rebind_row(std::size_t rowInd)
 {
+    // Long columns are not bound at all.
+    if (longColumn_)
+        return;
+
     void* elementPtr = NULL;
     SQLLEN size = 0;
     switch (type_)
@@ -197,6 +201,190 @@ void odbc_vector_into_type_backend::rebind_row(std::size_t rowInd)
     }
 }
 
+std::size_t odbc_vector_into_type_backend::get_row_element_size() const
+{
+    switch (type_)
+    {
+    case x_short:
+        return sizeof(short);
+    case x_integer:
+        return sizeof(SQLINTEGER);
+    case x_long_long:
+    case x_unsigned_long_long:
+        if (!use_string_for_bigint())
+            return sizeof(long long);
+        break;
+    case x_double:
+        return sizeof(double);
+    default:
+        break;
+    }
+
+    // It's one of the types for which we use fixed buffer.
+    return colSize_;
+}
+
+void odbc_vector_into_type_backend::bind_row_wise(char *rowBuf,
+    std::size_t rowSize, std::size_t valueOffset, std::size_t indOffset)
+{
+    rowBuf_ = rowBuf;
+    rowSize_ = rowSize;
+    valueOffset_ = valueOffset;
+    indOffset_ = indOffset;
+
+    // With row-wise binding, the addresses of the value and indicator for the
+    // first row are used and the driver adds the row size to them for each
+    // subsequent row.
+    SOCI_GCC_WARNING_SUPPRESS(cast-align)
+
+    SQLLEN * const ind = reinterpret_cast<SQLLEN*>(rowBuf + indOffset);
+
+    SOCI_GCC_WARNING_RESTORE(cast-align)
+
+    const SQLUSMALLINT pos = static_cast<SQLUSMALLINT>(position_ + 1);
+    SQLRETURN rc
+        = SQLBindCol(statement_.hstmt_, pos, odbcType_,
+            static_cast<SQLPOINTER>(rowBuf + valueOffset),
+            static_cast<SQLLEN>(get_row_element_size()), ind);
+    if (is_odbc_error(rc))
+    {
+        std::ostringstream ss;
+        ss << "binding column #" << pos << " row-wise";
+        throw odbc_soci_error(SQL_HANDLE_STMT, statement_.hstmt_, ss.str());
+    }
+}
+
+namespace
+{
+
+// Copy the simple values stored in the row-wise buffer into the vector.
+template <typename T>
+void copy_simple_values(void *data, char const *buf, std::size_t stride,
+                        std::size_t rows)
+{
+    std::vector<T> &v = *static_cast<std::vector<T> *>(data);
+    for (std::size_t i = 0; i != rows; ++i, buf += stride)
+    {
+        std::memcpy(&v[i], buf, sizeof(T));
+    }
+}
+
+} // anonymous namespace
+
+void odbc_vector_into_type_backend::do_post_fetch_row_wise(std::size_t rows)
+{
+    // Copy the indicators first as they're used by copy_from_buffer().
+    char const *ind = rowBuf_ + indOffset_;
+    for (std::size_t i = 0; i != rows; ++i, ind += rowSize_)
+    {
+        SQLLEN val;
+        std::memcpy(&val, ind, sizeof(val));
+        set_sqllen_from_vector_at(i, get_sqllen_from_value(val));
+    }
+
+    char const * const buf = rowBuf_ + valueOffset_;
+    switch (type_)
+    {
+    case x_short:
+        copy_simple_values<short>(data_, buf, rowSize_, rows);
+        return;
+    case x_integer:
+        copy_simple_values<int>(data_, buf, rowSize_, rows);
+        return;
+    case x_long_long:
+        if (!use_string_for_bigint())
+        {
+            copy_simple_values<long long>(data_, buf, rowSize_, rows);
+            return;
+        }
+        break;
+    case x_unsigned_long_long:
+        if (!use_string_for_bigint())
+        {
+            copy_simple_values<unsigned long long>(data_, buf, rowSize_, rows);
+            return;
+        }
+        break;
+    case x_double:
+        copy_simple_values<double>(data_, buf, rowSize_, rows);
+        return;
+    default:
+        break;
+    }
+
+    copy_from_buffer(buf, rowSize_, 0, rows);
+}
+
+void odbc_vector_into_type_backend::get_long_value(std::size_t rowInd)
+{
+    std::string& value = vector_string_value(type_, data_, rowInd);
+    value.clear();
+
+    const SQLUSMALLINT pos = static_cast<SQLUSMALLINT>(position_ + 1);
+    char buf[ODBC_MAX_COL_SIZE];
+    for (;;)
+    {
+        SQLLEN len = 0;
+        SQLRETURN rc = SQLGetData(statement_.hstmt_, pos, SQL_C_CHAR,
+                                  buf, sizeof(buf), &len);
+
+        // This is returned if the previous call retrieved all the data.
+        if (rc == SQL_NO_DATA)
+            break;
+
+        if (is_odbc_error(rc))
+        {
+            std::ostringstream ss;
+            ss << "getting value at index " << rowInd
+               << " of column #" << pos;
+            throw odbc_soci_error(SQL_HANDLE_STMT, statement_.hstmt_, ss.str());
+        }
+
+        len = get_sqllen_from_value(len);
+        if (len == SQL_NULL_DATA)
+        {
+            set_sqllen_from_vector_at(rowInd, SQL_NULL_DATA);
+            return;
+        }
+
+        // If the data was not truncated, this was the last chunk. Notice
+        // that SQL_SUCCESS_WITH_INFO may be returned for other warnings too,
+        // so check the length rather than relying on the return code only.
+        if (rc == SQL_SUCCESS ||
+                (len != SQL_NO_TOTAL &&
+                    static_cast<std::size_t>(len) < sizeof(buf)))
+        {
+            value.append(buf, static_cast<std::size_t>(len));
+            break;
+        }
+
+        // Otherwise the buffer is full, and the total length of the
+        // remaining data may be known, so use it to avoid reallocations.
+        if (len != SQL_NO_TOTAL && value.empty())
+            value.reserve(static_cast<std::size_t>(len));
+
+        // Don't count the trailing NUL.
+        value.append(buf, sizeof(buf) - 1);
+    }
+
+    set_sqllen_from_vector_at(rowInd, static_cast<SQLLEN>(value.size()));
+}
+
+void odbc_vector_into_type_backend::bind_long_column()
+{
+    longColumn_ = false;
+
+    // We need to fetch rows one by one with huge buffer size as otherwise we
+    // could easily run out of memory. Note that the flag is permanent for the
+    // statement and will never be reset.
+    statement_.fetchVectorByRows_ = true;
+
+    colSize_ = odbc_max_buffer_length + 1;
+    buf_ = new char[colSize_];
+
+    rebind_row(0);
+}
+
 void odbc_vector_into_type_backend::pre_fetch()
 {
     // nothing to do for the supported types
@@ -204,6 +392,17 @@ void odbc_vector_into_type_backend::pre_fetch()
 
 void odbc_vector_into_type_backend::do_post_fetch_rows(
     std::size_t beginRow, std::size_t endRow)
+{
+    // Values of long columns are retrieved by get_long_value() instead.
+    if (longColumn_)
+        return;
+
+    copy_from_buffer(buf_, colSize_, beginRow, endRow);
+}
+
+void odbc_vector_into_type_backend::copy_from_buffer(
+    char const *buf, std::size_t stride,
+    std::size_t beginRow, std::size_t endRow)
 {
     if (type_ == x_char)
     {
@@ -211,17 +410,17 @@ void odbc_vector_into_type_backend::do_post_fetch_rows(
             = static_cast<std::vector<char> *>(data_);
 
         std::vector<char> &v(*vp);
-        char *pos = buf_;
+        char const *pos = buf;
         for (std::size_t i = beginRow; i != endRow; ++i)
         {
             v[i] = *pos;
-            pos += colSize_;
+            pos += stride;
         }
     }
     if (type_ == x_stdstring || type_ == x_xmltype || type_ == x_longstring)
     {
-        const char *pos = buf_;
-        for (std::size_t i = beginRow; i != endRow; ++i, pos += colSize_)
+        char const *pos = buf;
+        for (std::size_t i = beginRow; i != endRow; ++i, pos += stride)
         {
             SQLLEN const len = get_sqllen_from_vector_at(i);
 
@@ -264,20 +463,20 @@ void odbc_vector_into_type_backend::do_post_fetch_rows(
             = static_cast<std::vector<std::tm> *>(data_);
 
         std::vector<std::tm> &v(*vp);
-        char *pos = buf_;
+        char const *pos = buf;
         for (std::size_t i = beginRow; i != endRow; ++i)
         {
             // See comment for the use of this macro in standard-into-type.cpp.
             SOCI_GCC_WARNING_SUPPRESS(cast-align)
 
-            TIMESTAMP_STRUCT * ts = reinterpret_cast<TIMESTAMP_STRUCT*>(pos);
+            TIMESTAMP_STRUCT const * ts = reinterpret_cast<TIMESTAMP_STRUCT const*>(pos);
 
             SOCI_GCC_WARNING_RESTORE(cast-align)
 
             details::mktime_from_ymdhms(v[i],
                                         ts->year, ts->month, ts->day,
                                         ts->hour, ts->minute, ts->second);
-            pos += colSize_;
+            pos += stride;
         }
     }
     else if (type_ == x_long_long && use_string_for_bigint())
@@ -285,14 +484,14 @@ void odbc_vector_into_type_backend::do_post_fetch_rows(
         std::vector<long long> *vp
             = static_cast<std::vector<long long> *>(data_);
         std::vector<long long> &v(*vp);
-        char *pos = buf_;
+        char const *pos = buf;
         for (std::size_t i = beginRow; i != endRow; ++i)
         {
             if (!cstring_to_integer(v[i], pos))
             {
                 throw soci_error("Failed to parse the returned 64-bit integer value");
             }
-            pos += colSize_;
+            pos += stride;
         }
     }
     else if (type_ == x_unsigned_long_long && use_string_for_bigint())
@@ -300,14 +499,14 @@ void odbc_vector_into_type_backend::do_post_fetch_rows(
         std::vector<unsigned long long> *vp
             = static_cast<std::vector<unsigned long long> *>(data_);
         std::vector<unsigned long long> &v(*vp);
-        char *pos = buf_;
+        char const *pos = buf;
         for (std::size_t i = beginRow; i != endRow; ++i)
         {
             if (!cstring_to_unsigned(v[i], pos))
             {
                 throw soci_error("Failed to parse the returned 64-bit integer value");
             }
-            pos += colSize_;
+            pos += stride;
         }
     }
 }
@@ -359,6 +558,8 @@ void odbc_vector_into_type_backend::clean_up()
         delete [] buf_;
         buf_ = NULL;
     }
+    longColumn_ = false;
+    rowBuf_ = NULL;
     std::vector<odbc_vector_into_type_backend*>::iterator it
         = std::find(statement_.intos_.begin(), statement_.intos_.end(), this);
     if (it != statement_.intos_.end())
@@ -10,16 +10,40 @@
 
 #include <algorithm>
 #include <cstring>
+#include <sstream>
 
 using namespace soci;
+using namespace sqlite_api;
+
+namespace // anonymous
+{
+
+void check_blob_err(sqlite3_session_backend &session, int res, char const *op)
+{
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << "sqlite3_blob_backend::" << op << ": "
+           << sqlite3_errmsg(session.conn_);
+        throw sqlite3_soci_error(ss.str(), res);
+    }
+}
+
+} // namespace anonymous
 
 sqlite3_blob_backend::sqlite3_blob_backend(sqlite3_session_backend &session)
-    : session_(session), buf_(0), len_(0)
+    : session_(session), buf_(0), len_(0), blob_(0)
 {
 }
 
 sqlite3_blob_backend::~sqlite3_blob_backend()
 {
+    if (blob_)
+    {
+        sqlite3_blob_close(blob_);
+        blob_ = 0;
+    }
+
     if (buf_)
     {
         delete [] buf_;
@@ -28,13 +52,95 @@ sqlite3_blob_backend::~sqlite3_blob_backend()
     }
 }
 
+void sqlite3_blob_backend::open(std::string const &table,
+                                std::string const &column,
+                                sqlite3_int64 rowid, bool readOnly,
+                                std::string const &database)
+{
+    close();
+
+    int const res = sqlite3_blob_open(session_.conn_, database.c_str(),
+                                      table.c_str(), column.c_str(), rowid,
+                                      readOnly ? 0 : 1, &blob_);
+    if (res != SQLITE_OK)
+    {
+        // sqlite3_blob_open() may return a handle even in case of error.
+        if (blob_)
+        {
+            sqlite3_blob_close(blob_);
+            blob_ = 0;
+        }
+
+        check_blob_err(session_, res, "open");
+    }
+
+    // the in-memory data, if any, is not used any more
+    if (buf_)
+    {
+        delete [] buf_;
+        buf_ = 0;
+        len_ = 0;
+    }
+}
+
+void sqlite3_blob_backend::reopen(sqlite3_int64 rowid)
+{
+    if (!blob_)
+        throw soci_error("BLOB must be opened before it can be reopened.");
+
+#if SQLITE_VERSION_NUMBER >= 3007004
+    int const res = sqlite3_blob_reopen(blob_, rowid);
+    if (res != SQLITE_OK)
+    {
+        // the handle is unusable after a failure to reopen it
+        sqlite3_blob_close(blob_);
+        blob_ = 0;
+
+        check_blob_err(session_, res, "reopen");
+    }
+#else
+    (void)rowid;
+    throw soci_error("Reopening BLOBs requires SQLite 3.7.4 or later.");
+#endif
+}
+
+void sqlite3_blob_backend::close()
+{
+    if (blob_)
+    {
+        int const res = sqlite3_blob_close(blob_);
+        blob_ = 0;
+
+        check_blob_err(session_, res, "close");
+    }
+}
+
 std::size_t sqlite3_blob_backend::get_len()
 {
+    if (blob_)
+        return static_cast<std::size_t>(sqlite3_blob_bytes(blob_));
+
     return len_;
 }
 
 std::size_t sqlite3_blob_backend::read_from_start(char * buf, std::size_t toRead, std::size_t offset)
 {
+    if (blob_)
+    {
+        std::size_t const len = get_len();
+        if (offset >= len)
+            return 0;
+
+        std::size_t const r = (std::min)(toRead, len - offset);
+
+        check_blob_err(session_,
+                       sqlite3_blob_read(blob_, buf, static_cast<int>(r),
+                                         static_cast<int>(offset)),
+                       "read_from_start");
+
+        return r;
+    }
+
     size_t r = toRead;
 
     // make sure that we don't try to read
@@ -52,6 +158,23 @@ std::size_t sqlite3_blob_backend::read_from_start(char * buf, std::size_t toRead
 
 std::size_t sqlite3_blob_backend::write_from_start(char const * buf, std::size_t toWrite, std::size_t offset)
 {
+    if (blob_)
+    {
+        std::size_t const len = get_len();
+        if (offset + toWrite > len)
+        {
+            throw soci_error("Writing past the end of the BLOB opened "
+                             "for incremental I/O is not supported.");
+        }
+
+        check_blob_err(session_,
+                       sqlite3_blob_write(blob_, buf, static_cast<int>(toWrite),
+                                          static_cast<int>(offset)),
+                       "write_from_start");
+
+        return len;
+    }
+
     const char* oldBuf = buf_;
     std::size_t oldLen = len_;
     len_ = (std::max)(len_, offset + toWrite);
@@ -75,6 +198,12 @@ std::size_t sqlite3_blob_backend::write_from_start(char const * buf, std::size_t
 std::size_t sqlite3_blob_backend::append(
     char const * buf, std::size_t toWrite)
 {
+    if (blob_)
+    {
+        throw soci_error("Appending to the BLOB opened "
+                         "for incremental I/O is not supported.");
+    }
+
     const char* oldBuf = buf_;
 
     buf_ = new char[len_ + toWrite];
@@ -93,6 +222,12 @@ std::size_t sqlite3_blob_backend::append(
 
 void sqlite3_blob_backend::trim(std::size_t newLen)
 {
+    if (blob_)
+    {
+        throw soci_error("Trimming the BLOB opened "
+                         "for incremental I/O is not supported.");
+    }
+
     const char* oldBuf = buf_;
     len_ = newLen;
 
@@ -105,6 +240,9 @@ void sqlite3_blob_backend::trim(std::size_t newLen)
 
 std::size_t sqlite3_blob_backend::set_data(char const *buf, std::size_t toWrite)
 {
+    // the new data replaces the BLOB in the database, if any
+    close();
+
     if (buf_)
     {
         delete [] buf_;
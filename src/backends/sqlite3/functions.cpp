@@ -0,0 +1,201 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SQLITE3_SOURCE
+#include "soci/sqlite3/soci-sqlite3.h"
+#include "soci-mktime.h"
+#include "soci-exchange-cast.h"
+// std
+#include <cstdio>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace soci;
+using namespace soci::details;
+using namespace sqlite_api;
+
+void soci::details::sqlite3_get_function_arg(sqlite3_value *arg,
+                                             exchange_type type, void *data)
+{
+    switch (type)
+    {
+        case x_char:
+        {
+            const char *buf = reinterpret_cast<const char*>(
+                sqlite3_value_text(arg));
+            exchange_type_cast<x_char>(data) = (buf && *buf) ? *buf : '\0';
+            break;
+        }
+
+        case x_stdstring:
+        {
+            // sqlite3_value_text() must be called before sqlite3_value_bytes()
+            const char *buf = reinterpret_cast<const char*>(
+                sqlite3_value_text(arg));
+            std::string &s = exchange_type_cast<x_stdstring>(data);
+            if (buf)
+                s.assign(buf, sqlite3_value_bytes(arg));
+            else
+                s.clear();
+            break;
+        }
+
+        case x_short:
+            exchange_type_cast<x_short>(data)
+                = static_cast<short>(sqlite3_value_int(arg));
+            break;
+
+        case x_integer:
+            exchange_type_cast<x_integer>(data) = sqlite3_value_int(arg);
+            break;
+
+        case x_long_long:
+            exchange_type_cast<x_long_long>(data) = sqlite3_value_int64(arg);
+            break;
+
+        case x_unsigned_long_long:
+            exchange_type_cast<x_unsigned_long_long>(data)
+                = static_cast<unsigned long long>(sqlite3_value_int64(arg));
+            break;
+
+        case x_double:
+            exchange_type_cast<x_double>(data) = sqlite3_value_double(arg);
+            break;
+
+        case x_stdtm:
+        {
+            const char *buf = reinterpret_cast<const char*>(
+                sqlite3_value_text(arg));
+            parse_std_tm((buf ? buf : ""), exchange_type_cast<x_stdtm>(data));
+            break;
+        }
+
+        default:
+            throw soci_error("Unsupported SQLite function argument type.");
+    }
+}
+
+void soci::details::sqlite3_set_function_result(sqlite3_context *ctx,
+                                                exchange_type type,
+                                                void const *data)
+{
+    switch (type)
+    {
+        case x_char:
+            sqlite3_result_text(ctx, static_cast<char const *>(data), 1,
+                                SQLITE_TRANSIENT);
+            break;
+
+        case x_stdstring:
+        {
+            std::string const &s = *static_cast<std::string const *>(data);
+            sqlite3_result_text(ctx, s.c_str(), static_cast<int>(s.size()),
+                                SQLITE_TRANSIENT);
+            break;
+        }
+
+        case x_short:
+            sqlite3_result_int(ctx, *static_cast<short const *>(data));
+            break;
+
+        case x_integer:
+            sqlite3_result_int(ctx, *static_cast<int const *>(data));
+            break;
+
+        case x_long_long:
+            sqlite3_result_int64(ctx, *static_cast<long long const *>(data));
+            break;
+
+        case x_unsigned_long_long:
+            sqlite3_result_int64(ctx, static_cast<sqlite3_int64>(
+                *static_cast<unsigned long long const *>(data)));
+            break;
+
+        case x_double:
+            sqlite3_result_double(ctx, *static_cast<double const *>(data));
+            break;
+
+        case x_stdtm:
+        {
+            std::tm const &t = *static_cast<std::tm const *>(data);
+            char buf[20];
+            int const len = snprintf(buf, sizeof(buf),
+                                     "%d-%02d-%02d %02d:%02d:%02d",
+                                     t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+                                     t.tm_hour, t.tm_min, t.tm_sec);
+            sqlite3_result_text(ctx, buf, len, SQLITE_TRANSIENT);
+            break;
+        }
+
+        default:
+            sqlite3_set_function_error(ctx,
+                "Unsupported SQLite function result type.");
+    }
+}
+
+void soci::details::sqlite3_set_function_error(sqlite3_context *ctx,
+                                               char const *msg)
+{
+    sqlite3_result_error(ctx, msg, -1);
+}
+
+void *soci::details::sqlite3_get_function_data(sqlite3_context *ctx)
+{
+    return sqlite3_user_data(ctx);
+}
+
+void **soci::details::sqlite3_get_aggregate_state(sqlite3_context *ctx,
+                                                  bool create)
+{
+    void **state = static_cast<void **>(
+        sqlite3_aggregate_context(ctx, create ? sizeof(void *) : 0));
+    if (create && !state)
+        throw std::bad_alloc();
+
+    return state;
+}
+
+void sqlite3_session_backend::register_function(std::string const &name,
+    int arity, bool deterministic, void *userData,
+    void (*func)(sqlite3_context *, int, sqlite3_value **),
+    void (*step)(sqlite3_context *, int, sqlite3_value **),
+    void (*finish)(sqlite3_context *),
+    void (*destroy)(void *))
+{
+    int flags = SQLITE_UTF8;
+#ifdef SQLITE_DETERMINISTIC
+    if (deterministic)
+        flags |= SQLITE_DETERMINISTIC;
+#else
+    (void)deterministic;
+#endif
+
+    int const res = sqlite3_create_function_v2(conn_, name.c_str(), arity,
+                                               flags, userData, func, step,
+                                               finish, destroy);
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << "Cannot register function \"" << name << "\": "
+           << sqlite3_errmsg(conn_);
+        throw sqlite3_soci_error(ss.str(), res);
+    }
+}
+
+void sqlite3_session_backend::remove_function(std::string const &name,
+                                              int arity)
+{
+    int const res = sqlite3_create_function_v2(conn_, name.c_str(), arity,
+                                               SQLITE_UTF8, 0, 0, 0, 0, 0);
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << "Cannot remove function \"" << name << "\": "
+           << sqlite3_errmsg(conn_);
+        throw sqlite3_soci_error(ss.str(), res);
+    }
+}
@@ -0,0 +1,392 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SQLITE3_SOURCE
+#include "soci/sqlite3/soci-sqlite3.h"
+// std
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <string>
+
+using namespace soci;
+using namespace soci::details;
+using namespace sqlite_api;
+
+#if SQLITE_VERSION_NUMBER >= 3009000
+
+namespace // anonymous
+{
+
+// The memory tables are implemented as eponymous-only virtual tables, i.e.
+// each of them is a separate module, which can be used directly under its
+// name without creating the table itself.
+
+struct memory_vtab
+{
+    sqlite3_vtab base_;
+    sqlite3_memory_table const *table_;
+};
+
+struct memory_cursor
+{
+    sqlite3_vtab_cursor base_;
+    sqlite3_int64 row_;
+    sqlite3_int64 end_;
+};
+
+// Values of sqlite3_index_info::idxNum used by us.
+enum
+{
+    scan_all,
+    scan_rowid
+};
+
+char const *get_column_type(exchange_type type)
+{
+    switch (type)
+    {
+        case x_short:
+        case x_integer:
+        case x_long_long:
+        case x_unsigned_long_long:
+            return "integer";
+
+        case x_double:
+            return "real";
+
+        case x_char:
+        case x_stdstring:
+        case x_stdtm:
+            return "text";
+
+        default:
+            return 0;
+    }
+}
+
+int memory_connect(sqlite_api::sqlite3 *conn, void *aux, int, char const * const *,
+                   sqlite3_vtab **vtab, char **errMsg)
+{
+    sqlite3_memory_table const *table
+        = static_cast<sqlite3_memory_table const *>(aux);
+
+    std::ostringstream ss;
+    ss << "create table x(";
+    for (std::size_t i = 0; i != table->columns().size(); ++i)
+    {
+        sqlite3_memory_table::column const &c = table->columns()[i];
+        char const *const type = get_column_type(c.type_);
+        if (!type)
+        {
+            *errMsg = sqlite3_mprintf("unsupported type of column \"%s\"",
+                                      c.name_.c_str());
+            return SQLITE_ERROR;
+        }
+
+        if (i)
+            ss << ", ";
+        ss << '"' << c.name_ << "\" " << type;
+    }
+    ss << ")";
+
+    int const res = sqlite3_declare_vtab(conn, ss.str().c_str());
+    if (res != SQLITE_OK)
+        return res;
+
+    memory_vtab *const v
+        = static_cast<memory_vtab *>(sqlite3_malloc(sizeof(memory_vtab)));
+    if (!v)
+        return SQLITE_NOMEM;
+
+    std::memset(v, 0, sizeof(memory_vtab));
+    v->table_ = table;
+    *vtab = &v->base_;
+
+    return SQLITE_OK;
+}
+
+int memory_disconnect(sqlite3_vtab *vtab)
+{
+    sqlite3_free(vtab);
+    return SQLITE_OK;
+}
+
+// Return the number of rows in the table or -1, after setting the error
+// message, if the columns have different sizes.
+sqlite3_int64 get_rows_count(memory_vtab *v)
+{
+    std::vector<sqlite3_memory_table::column> const &
+        columns = v->table_->columns();
+    if (columns.empty())
+        return 0;
+
+    std::size_t const rows = columns[0].get_size_(columns[0].vector_);
+    for (std::size_t i = 0; i != columns.size(); ++i)
+    {
+        sqlite3_memory_table::column const &c = columns[i];
+        if (c.get_size_(c.vector_) != rows ||
+                (c.inds_ && c.inds_->size() != rows))
+        {
+            sqlite3_free(v->base_.zErrMsg);
+            v->base_.zErrMsg = sqlite3_mprintf(
+                "size of column \"%s\" differs from the number of rows",
+                c.name_.c_str());
+            return -1;
+        }
+    }
+
+    return static_cast<sqlite3_int64>(rows);
+}
+
+int memory_best_index(sqlite3_vtab *vtab, sqlite3_index_info *info)
+{
+    memory_vtab *const v = reinterpret_cast<memory_vtab *>(vtab);
+
+    // Row IDs are just the indices of the rows, so a row can be looked up by
+    // its ID directly, anything else requires a full scan.
+    for (int i = 0; i != info->nConstraint; ++i)
+    {
+        sqlite3_index_info::sqlite3_index_constraint const &
+            c = info->aConstraint[i];
+        if (c.usable && c.iColumn == -1 && c.op == SQLITE_INDEX_CONSTRAINT_EQ)
+        {
+            info->aConstraintUsage[i].argvIndex = 1;
+            info->aConstraintUsage[i].omit = 1;
+            info->idxNum = scan_rowid;
+            info->idxFlags = SQLITE_INDEX_SCAN_UNIQUE;
+            info->estimatedCost = 1;
+            info->estimatedRows = 1;
+            return SQLITE_OK;
+        }
+    }
+
+    sqlite3_int64 const rows = get_rows_count(v);
+    info->idxNum = scan_all;
+    info->estimatedCost = rows > 0 ? static_cast<double>(rows) : 1;
+    info->estimatedRows = rows > 0 ? rows : 1;
+
+    return SQLITE_OK;
+}
+
+int memory_open(sqlite3_vtab *, sqlite3_vtab_cursor **cursor)
+{
+    memory_cursor *const c
+        = static_cast<memory_cursor *>(sqlite3_malloc(sizeof(memory_cursor)));
+    if (!c)
+        return SQLITE_NOMEM;
+
+    std::memset(c, 0, sizeof(memory_cursor));
+    *cursor = &c->base_;
+
+    return SQLITE_OK;
+}
+
+int memory_close(sqlite3_vtab_cursor *cursor)
+{
+    sqlite3_free(cursor);
+    return SQLITE_OK;
+}
+
+int memory_filter(sqlite3_vtab_cursor *cursor, int idxNum, char const *,
+                  int, sqlite3_value **argv)
+{
+    memory_cursor *const c = reinterpret_cast<memory_cursor *>(cursor);
+    memory_vtab *const v = reinterpret_cast<memory_vtab *>(cursor->pVtab);
+
+    sqlite3_int64 const rows = get_rows_count(v);
+    if (rows < 0)
+        return SQLITE_ERROR;
+
+    c->row_ = 0;
+    c->end_ = rows;
+
+    if (idxNum == scan_rowid)
+    {
+        sqlite3_int64 const row = sqlite3_value_int64(argv[0]);
+        if (sqlite3_value_type(argv[0]) != SQLITE_NULL &&
+                row >= 0 && row < rows)
+        {
+            c->row_ = row;
+            c->end_ = row + 1;
+        }
+        else
+        {
+            c->end_ = 0;
+        }
+    }
+
+    return SQLITE_OK;
+}
+
+int memory_next(sqlite3_vtab_cursor *cursor)
+{
+    ++reinterpret_cast<memory_cursor *>(cursor)->row_;
+    return SQLITE_OK;
+}
+
+int memory_eof(sqlite3_vtab_cursor *cursor)
+{
+    memory_cursor *const c = reinterpret_cast<memory_cursor *>(cursor);
+    return c->row_ >= c->end_;
+}
+
+int memory_column(sqlite3_vtab_cursor *cursor, sqlite3_context *ctx, int col)
+{
+    memory_cursor *const c = reinterpret_cast<memory_cursor *>(cursor);
+    memory_vtab *const v = reinterpret_cast<memory_vtab *>(cursor->pVtab);
+
+    sqlite3_memory_table::column const &column = v->table_->columns()[col];
+    std::size_t const row = static_cast<std::size_t>(c->row_);
+
+    if (column.inds_ && (*column.inds_)[row] == i_null)
+    {
+        sqlite3_result_null(ctx);
+        return SQLITE_OK;
+    }
+
+    void const *const data = column.get_data_(column.vector_);
+    switch (column.type_)
+    {
+        case x_char:
+            sqlite3_result_text(ctx, static_cast<char const *>(data) + row, 1,
+                                SQLITE_STATIC);
+            break;
+
+        case x_stdstring:
+        {
+            // The strings are not copied.
+            std::string const &s = static_cast<std::string const *>(data)[row];
+            sqlite3_result_text(ctx, s.c_str(), static_cast<int>(s.size()),
+                                SQLITE_STATIC);
+            break;
+        }
+
+        case x_short:
+            sqlite3_result_int(ctx, static_cast<short const *>(data)[row]);
+            break;
+
+        case x_integer:
+            sqlite3_result_int(ctx, static_cast<int const *>(data)[row]);
+            break;
+
+        case x_long_long:
+            sqlite3_result_int64(ctx,
+                static_cast<long long const *>(data)[row]);
+            break;
+
+        case x_unsigned_long_long:
+            sqlite3_result_int64(ctx, static_cast<sqlite3_int64>(
+                static_cast<unsigned long long const *>(data)[row]));
+            break;
+
+        case x_double:
+            sqlite3_result_double(ctx, static_cast<double const *>(data)[row]);
+            break;
+
+        case x_stdtm:
+        {
+            std::tm const &t = static_cast<std::tm const *>(data)[row];
+            char buf[20];
+            int const len = snprintf(buf, sizeof(buf),
+                                     "%d-%02d-%02d %02d:%02d:%02d",
+                                     t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+                                     t.tm_hour, t.tm_min, t.tm_sec);
+            sqlite3_result_text(ctx, buf, len, SQLITE_TRANSIENT);
+            break;
+        }
+
+        default:
+            // Unsupported types are rejected in memory_connect().
+            return SQLITE_ERROR;
+    }
+
+    return SQLITE_OK;
+}
+
+int memory_rowid(sqlite3_vtab_cursor *cursor, sqlite3_int64 *rowid)
+{
+    *rowid = reinterpret_cast<memory_cursor *>(cursor)->row_;
+    return SQLITE_OK;
+}
+
+void destroy_table(void *aux)
+{
+    delete static_cast<sqlite3_memory_table *>(aux);
+}
+
+sqlite3_module make_memory_module()
+{
+    sqlite3_module module;
+    std::memset(&module, 0, sizeof(module));
+
+    // xCreate is left null for eponymous-only table.
+    module.xConnect = &memory_connect;
+    module.xBestIndex = &memory_best_index;
+    module.xDisconnect = &memory_disconnect;
+    module.xDestroy = &memory_disconnect;
+    module.xOpen = &memory_open;
+    module.xClose = &memory_close;
+    module.xFilter = &memory_filter;
+    module.xNext = &memory_next;
+    module.xEof = &memory_eof;
+    module.xColumn = &memory_column;
+    module.xRowid = &memory_rowid;
+
+    return module;
+}
+
+sqlite3_module const &get_memory_module()
+{
+    static sqlite3_module const module = make_memory_module();
+    return module;
+}
+
+} // namespace anonymous
+
+void sqlite3_session_backend::create_memory_table(std::string const &name,
+    sqlite3_memory_table const &table)
+{
+    int const res = sqlite3_create_module_v2(conn_, name.c_str(),
+                                             &get_memory_module(),
+                                             new sqlite3_memory_table(table),
+                                             &destroy_table);
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << "Cannot create memory table \"" << name << "\": "
+           << sqlite3_errmsg(conn_);
+        throw sqlite3_soci_error(ss.str(), res);
+    }
+}
+
+void sqlite3_session_backend::drop_memory_table(std::string const &name)
+{
+    int const res = sqlite3_create_module_v2(conn_, name.c_str(), 0, 0, 0);
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << "Cannot drop memory table \"" << name << "\": "
+           << sqlite3_errmsg(conn_);
+        throw sqlite3_soci_error(ss.str(), res);
+    }
+}
+
+#else // SQLITE_VERSION_NUMBER < 3009000
+
+void sqlite3_session_backend::create_memory_table(std::string const &,
+    sqlite3_memory_table const &)
+{
+    throw soci_error("Memory tables require SQLite 3.9.0 or later.");
+}
+
+void sqlite3_session_backend::drop_memory_table(std::string const &)
+{
+    throw soci_error("Memory tables require SQLite 3.9.0 or later.");
+}
+
+#endif // SQLITE_VERSION_NUMBER >= 3009000
@@ -81,6 +81,49 @@ void check_sqlite_err(sqlite_api::sqlite3* conn, int res, char const* const errM
     return check_sqlite_err(conn, res, [errMsg](std::ostream& ostr) { ostr << errMsg; });
 }
 
+// Copy the main database of the given connection to or from the database in
+// the given file using the backup API, replacing the destination contents.
+void copy_database(sqlite_api::sqlite3* conn, std::string const& filename,
+                   int flags, std::string const& vfs, bool toFile)
+{
+    sqlite_api::sqlite3* fileConn = NULL;
+    int res = sqlite3_open_v2(filename.c_str(), &fileConn, flags,
+                              vfs.empty() ? NULL : vfs.c_str());
+    check_sqlite_err(fileConn, res,
+        [&filename](std::ostream& ostr)
+        {
+            ostr << "Cannot open database file \"" << filename << "\"";
+        }
+    );
+
+    sqlite_api::sqlite3* const dst = toFile ? fileConn : conn;
+    sqlite_api::sqlite3* const src = toFile ? conn : fileConn;
+
+    sqlite_api::sqlite3_backup* const
+        backup = sqlite3_backup_init(dst, "main", src, "main");
+    if (backup)
+    {
+        // Copy all pages at once: we don't need to allow concurrent access
+        // while doing it.
+        sqlite3_backup_step(backup, -1);
+        sqlite3_backup_finish(backup);
+    }
+
+    // Errors of both sqlite3_backup_init() and sqlite3_backup_step() are
+    // returned by sqlite3_backup_finish() and stored in the destination.
+    res = sqlite3_errcode(dst);
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << "Cannot copy database " << (toFile ? "to" : "from")
+           << " \"" << filename << "\": " << sqlite3_errmsg(dst);
+        sqlite3_close(fileConn);
+        throw sqlite3_soci_error(ss.str(), res);
+    }
+
+    sqlite3_close(fileConn);
+}
+
 } // namespace anonymous
 
 static int sequence_table_exists_callback(void* ctxt, int result_columns, char**, char**)
@@ -107,13 +150,17 @@ static bool check_if_sequence_table_exists(sqlite_api::sqlite3* conn)
 
 sqlite3_session_backend::sqlite3_session_backend(
     connection_parameters const & parameters)
-    : sequence_table_exists_(false)
+    : sequence_table_exists_(false), bulkBatchSize_(0), statementCacheSize_(0)
 {
     int timeout = 0;
     int connection_flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
     std::string vfs;
     std::string synchronous;
     std::string foreignKeys;
+    std::string journalMode;
+    std::string mmapSize;
+    bool inMemory = false;
+    bool saveOnClose = false;
     std::string const & connectString = parameters.get_connect_string();
     std::string dbname(connectString);
     std::stringstream ssconn(connectString);
@@ -175,15 +222,86 @@ sqlite3_session_backend::sqlite3_session_backend(
         {
             foreignKeys = val;
         }
+        else if ("journal_mode" == key)
+        {
+            journalMode = val;
+        }
+        else if ("mmap_size" == key)
+        {
+            mmapSize = val;
+        }
+        else if ("in_memory" == key)
+        {
+            if ("save" == val)
+            {
+                inMemory = true;
+                saveOnClose = true;
+            }
+            else if ("true" == val)
+            {
+                inMemory = true;
+            }
+            else if ("false" != val)
+            {
+                throw soci_error("Invalid in_memory value \"" + val +
+                                 "\": must be true, false or save");
+            }
+        }
+        else if ("bulk_batch_size" == key)
+        {
+            if (!cstring_to_integer(bulkBatchSize_, val.c_str()) ||
+                    bulkBatchSize_ < 0)
+            {
+                throw soci_error("Invalid bulk_batch_size value \"" + val +
+                                 "\": must be a non-negative integer");
+            }
+        }
+        else if ("statement_cache_size" == key)
+        {
+            int size = 0;
+            if (!cstring_to_integer(size, val.c_str()) || size < 0)
+            {
+                throw soci_error("Invalid statement_cache_size value \"" + val +
+                                 "\": must be a non-negative integer");
+            }
+
+            statementCacheSize_ = static_cast<std::size_t>(size);
+        }
     }
 
-    int res = sqlite3_open_v2(dbname.c_str(), &conn_, connection_flags, (vfs.empty()?NULL:vfs.c_str()));
-    check_sqlite_err(conn_, res,
-        [&dbname](std::ostream& ostr)
+    int res;
+    if (inMemory)
+    {
+        res = sqlite3_open_v2(":memory:", &conn_,
+                              SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+        check_sqlite_err(conn_, res, "Cannot open in-memory database");
+
+        try
         {
-            ostr << "Cannot establish connection to \"" << dbname << "\"";
+            copy_database(conn_, dbname, connection_flags, vfs, false);
+        }
+        catch (...)
+        {
+            sqlite3_close(conn_);
+            throw;
         }
-    );
+
+        if (saveOnClose)
+        {
+            saveOnCloseFile_ = dbname;
+            saveOnCloseVfs_ = vfs;
+        }
+    }
+    else
+    {
+        res = sqlite3_open_v2(dbname.c_str(), &conn_, connection_flags, (vfs.empty()?NULL:vfs.c_str()));
+        check_sqlite_err(conn_, res,
+            [&dbname](std::ostream& ostr)
+            {
+                ostr << "Cannot establish connection to \"" << dbname << "\"";
+            }
+        );
+    }
 
     if (!synchronous.empty())
     {
@@ -207,6 +325,28 @@ sqlite3_session_backend::sqlite3_session_backend(
         );
     }
 
+    if (!journalMode.empty())
+    {
+        std::string const query("pragma journal_mode=" + journalMode);
+        execute_hardcoded(conn_, query.c_str(),
+            [&journalMode](std::ostream& ostr)
+            {
+                ostr << "Setting journal_mode pragma to \"" << journalMode << "\" failed";
+            }
+        );
+    }
+
+    if (!mmapSize.empty())
+    {
+        std::string const query("pragma mmap_size=" + mmapSize);
+        execute_hardcoded(conn_, query.c_str(),
+            [&mmapSize](std::ostream& ostr)
+            {
+                ostr << "Setting mmap_size pragma to \"" << mmapSize << "\" failed";
+            }
+        );
+    }
+
     res = sqlite3_busy_timeout(conn_, timeout * 1000);
     check_sqlite_err(conn_, res, "Failed to set busy timeout for connection. ");
 }
@@ -231,6 +371,35 @@ void sqlite3_session_backend::rollback()
     execute_hardcoded(conn_, "ROLLBACK", "Cannot rollback transaction.");
 }
 
+void sqlite3_session_backend::savepoint(char const* name)
+{
+    std::string const query = std::string("SAVEPOINT ") + name;
+    execute_hardcoded(conn_, query.c_str(), "Cannot create savepoint.");
+}
+
+void sqlite3_session_backend::release_savepoint(char const* name)
+{
+    std::string const query = std::string("RELEASE ") + name;
+    execute_hardcoded(conn_, query.c_str(), "Cannot release savepoint.");
+}
+
+void sqlite3_session_backend::rollback_to_savepoint(char const* name)
+{
+    std::string const query = std::string("ROLLBACK TO ") + name;
+    execute_hardcoded(conn_, query.c_str(), "Cannot rollback to savepoint.");
+}
+
+void sqlite3_session_backend::load_from(std::string const& filename)
+{
+    copy_database(conn_, filename, SQLITE_OPEN_READONLY, std::string(), false);
+}
+
+void sqlite3_session_backend::save_to(std::string const& filename)
+{
+    copy_database(conn_, filename, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                  std::string(), true);
+}
+
 // Argument passed to store_single_value_callback(), which is used to retrieve
 // a single numeric value from a hardcoded query.
 struct single_value_callback_ctx
@@ -311,9 +480,91 @@ bool sqlite3_session_backend::get_last_insert_id(
 
 void sqlite3_session_backend::clean_up()
 {
+    if (!saveOnCloseFile_.empty())
+    {
+        std::string const filename = saveOnCloseFile_;
+        saveOnCloseFile_.clear();
+
+        // This is called from the destructor, so there is no way to report
+        // the errors here: the applications which need to handle them should
+        // call save_to() explicitly before closing the session.
+        try
+        {
+            copy_database(conn_, filename,
+                          SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                          saveOnCloseVfs_, true);
+        }
+        catch (soci_error const&)
+        {
+        }
+    }
+
+    // all statements must be finalized before closing the connection
+    for (cached_statements::iterator it = statementCache_.begin();
+         it != statementCache_.end(); ++it)
+    {
+        sqlite3_finalize(it->second);
+    }
+    statementCache_.clear();
+    statementCacheIndex_.clear();
+
     sqlite3_close(conn_);
 }
 
+sqlite3_stmt *
+sqlite3_session_backend::take_cached_statement(std::string const & query)
+{
+    if (statementCacheIndex_.empty())
+        return NULL;
+
+    auto const it = statementCacheIndex_.find(query);
+    if (it == statementCacheIndex_.end())
+        return NULL;
+
+    sqlite3_stmt * const stmt = it->second->second;
+    statementCache_.erase(it->second);
+    statementCacheIndex_.erase(it);
+
+    return stmt;
+}
+
+void sqlite3_session_backend::release_statement(std::string const & query,
+                                                sqlite3_stmt * stmt)
+{
+    if (statementCacheSize_ == 0)
+    {
+        sqlite3_finalize(stmt);
+        return;
+    }
+
+    // make the statement ready to be executed again and ensure that it
+    // doesn't keep pointers to the data bound to it
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    if (statementCache_.size() == statementCacheSize_)
+    {
+        // evict the least recently used statement
+        cached_statements::iterator const last = --statementCache_.end();
+
+        auto range = statementCacheIndex_.equal_range(last->first);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == last)
+            {
+                statementCacheIndex_.erase(it);
+                break;
+            }
+        }
+
+        sqlite3_finalize(last->second);
+        statementCache_.erase(last);
+    }
+
+    statementCache_.push_front(std::make_pair(query, stmt));
+    statementCacheIndex_.insert(std::make_pair(query, statementCache_.begin()));
+}
+
 sqlite3_statement_backend * sqlite3_session_backend::make_statement_backend()
 {
     return new sqlite3_statement_backend(*this);
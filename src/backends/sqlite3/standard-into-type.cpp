@@ -8,6 +8,7 @@
 #define SOCI_SQLITE3_SOURCE
 #include "soci/soci-platform.h"
 #include "soci/sqlite3/soci-sqlite3.h"
+#include "soci/exchange-stats.h"
 #include "soci/rowid.h"
 #include "common.h"
 #include "soci/blob.h"
@@ -93,6 +94,7 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
                 exchange_type_traits<x_stdstring>::value_type &out
                     = exchange_type_cast<x_stdstring>(data_);
                 out.assign(buf, bytes);
+                count_bytes_copied(bytes);
                 break;
             }
 
@@ -174,6 +176,7 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
                 exchange_type_traits<x_xmltype>::value_type &out
                     = exchange_type_cast<x_xmltype>(data_);
                 out.value.assign(buf, bytes);
+                count_bytes_copied(bytes);
                 break;
             }
 
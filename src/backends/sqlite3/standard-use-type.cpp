@@ -170,6 +170,13 @@ void sqlite3_standard_use_type_backend::pre_use(indicator const * ind)
             blob *b = static_cast<blob *>(data_);
             sqlite3_blob_backend *bbe = static_cast<sqlite3_blob_backend *>(b->get_backend());
 
+            // the data of such BLOB is only in the database, not in memory
+            if (bbe->is_open())
+            {
+                throw soci_error(
+                    "BLOB opened for incremental I/O can't be used as parameter.");
+            }
+
             col.buffer_.constData_ = bbe->get_buffer();
             col.buffer_.size_ = bbe->get_len();
             break;
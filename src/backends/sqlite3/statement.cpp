@@ -7,6 +7,7 @@
 
 #define SOCI_SQLITE3_SOURCE
 #include "soci/sqlite3/soci-sqlite3.h"
+#include "soci/exchange-stats.h"
 // std
 #include <algorithm>
 #include <cctype>
@@ -29,6 +30,66 @@ using namespace soci;
 using namespace soci::details;
 using namespace sqlite_api;
 
+char *sqlite3_arena::allocate(std::size_t size)
+{
+    // Use the first chunk with enough space remaining in it.
+    for (; current_ < chunks_.size(); ++current_, used_ = 0)
+    {
+        chunk &c = chunks_[current_];
+        if (c.size() - used_ >= size)
+        {
+            char * const p = &c[0] + used_;
+            used_ += size;
+            return p;
+        }
+    }
+
+    // Allocate a new chunk at least twice bigger than the last one, so that
+    // only a logarithmic number of them is needed.
+    std::size_t chunkSize = chunks_.empty() ? 4096 : 2*chunks_.back().size();
+    if (chunkSize < size)
+        chunkSize = size;
+
+    chunks_.push_back(chunk(chunkSize));
+    current_ = chunks_.size() - 1;
+    used_ = size;
+
+    return &chunks_.back()[0];
+}
+
+void sqlite3_arena::reset()
+{
+    // If the previous fetch needed more than one chunk, replace them with a
+    // single one big enough to hold all of them to avoid the fragmentation.
+    if (chunks_.size() > 1)
+    {
+        std::size_t total = 0;
+        for (std::vector<chunk>::const_iterator it = chunks_.begin();
+             it != chunks_.end(); ++it)
+        {
+            total += it->size();
+        }
+
+        chunks_.clear();
+        chunks_.push_back(chunk(total));
+    }
+
+    current_ = 0;
+    used_ = 0;
+}
+
+void sqlite3_recordset::reset(std::size_t rows, std::size_t columns)
+{
+    if (rows * columns > cells_.size())
+        cells_.resize(rows * columns);
+
+    rows_ = 0;
+    capacity_ = rows;
+    columns_ = columns;
+
+    arena_.reset();
+}
+
 sqlite3_statement_backend::sqlite3_statement_backend(
     sqlite3_session_backend &session)
     : session_(session)
@@ -40,6 +101,7 @@ sqlite3_statement_backend::sqlite3_statement_backend(
     , boundByPos_(false)
     , hasVectorIntoElements_(false)
     , rowsAffectedBulk_(-1LL)
+    , bulkBatchSize_(session.bulkBatchSize_)
 {
 }
 
@@ -54,7 +116,8 @@ void sqlite3_statement_backend::clean_up()
 
     if (stmt_)
     {
-        sqlite3_finalize(stmt_);
+        // this finalizes the statement unless the statement cache is used
+        session_.release_statement(query_, stmt_);
         stmt_ = 0;
         databaseReady_ = false;
     }
@@ -65,6 +128,15 @@ void sqlite3_statement_backend::prepare(std::string const & query,
 {
     clean_up();
 
+    query_ = query;
+
+    stmt_ = session_.take_cached_statement(query);
+    if (stmt_)
+    {
+        databaseReady_ = true;
+        return;
+    }
+
     char const* tail = 0; // unused;
     int const res = sqlite3_prepare_v2(session_.conn_,
                               query.c_str(),
@@ -130,12 +202,19 @@ sqlite3_statement_backend::load_rowset(int totalRows)
     }
     else
     {
-        // make the vector big enough to hold the data we need
-        dataCache_.resize(totalRows);
-        for (sqlite3_recordset::iterator it = dataCache_.begin(),
-            end = dataCache_.end(); it != end; ++it)
+        // make the cache big enough to hold the data we need, this doesn't
+        // allocate anything if it was already used for a previous fetch
+        dataCache_.reset(totalRows, numCols);
+
+        // find the columns which can be stored directly in the vectors
+        // without going through the cache, this avoids copying their values
+        directIntos_.assign(numCols, NULL);
+        int const numIntos = (std::min)(numCols, static_cast<int>(vectorIntos_.size()));
+        for (int c = 0; c < numIntos; ++c)
         {
-            (*it).resize(numCols);
+            sqlite3_vector_into_type_backend * const vi = vectorIntos_[c];
+            if (vi && vi->prepare_direct_fetch(columns_[c].type_, totalRows))
+                directIntos_[c] = vi;
         }
 
         for (i = 0; i < totalRows && databaseReady_; ++i)
@@ -152,8 +231,14 @@ sqlite3_statement_backend::load_rowset(int totalRows)
             {
                 for (int c = 0; c < numCols; ++c)
                 {
+                    if (directIntos_[c])
+                    {
+                        directIntos_[c]->fetch_directly(i);
+                        continue;
+                    }
+
                     const sqlite3_column_info &coldef = columns_[c];
-                    sqlite3_column &col = dataCache_[i][c];
+                    sqlite3_column &col = dataCache_.at(i, c);
 
                     if (sqlite3_column_type(stmt_, c) == SQLITE_NULL)
                     {
@@ -168,10 +253,17 @@ sqlite3_statement_backend::load_rowset(int totalRows)
                     {
                         case dt_string:
                         case dt_date:
+                        {
+                            // Note that sqlite3_column_text() must be called
+                            // before sqlite3_column_bytes() as it may convert
+                            // the value and change its size.
+                            const unsigned char *text = sqlite3_column_text(stmt_, c);
                             col.buffer_.size_ = sqlite3_column_bytes(stmt_, c);
-                            col.buffer_.data_ = new char[col.buffer_.size_+1];
-                            memcpy(col.buffer_.data_, sqlite3_column_text(stmt_, c), col.buffer_.size_+1);
+                            col.buffer_.data_ = dataCache_.allocate(col.buffer_.size_+1);
+                            memcpy(col.buffer_.data_, text, col.buffer_.size_+1);
+                            count_bytes_copied(col.buffer_.size_);
                             break;
+                        }
 
                         case dt_double:
                             col.double_ = sqlite3_column_double(stmt_, c);
@@ -187,10 +279,15 @@ sqlite3_statement_backend::load_rowset(int totalRows)
                             break;
 
                         case dt_blob:
+                        {
+                            const void *blob = sqlite3_column_blob(stmt_, c);
                             col.buffer_.size_ = sqlite3_column_bytes(stmt_, c);
-                            col.buffer_.data_ = (col.buffer_.size_ > 0 ? new char[col.buffer_.size_] : NULL);
-                            memcpy(col.buffer_.data_, sqlite3_column_blob(stmt_, c), col.buffer_.size_);
+                            col.buffer_.data_ = (col.buffer_.size_ > 0 ? dataCache_.allocate(col.buffer_.size_) : NULL);
+                            if (col.buffer_.size_ > 0)
+                                memcpy(col.buffer_.data_, blob, col.buffer_.size_);
+                            count_bytes_copied(col.buffer_.size_);
                             break;
+                        }
 
                         case dt_xml:
                             throw soci_error("XML data type is not supported");
@@ -207,8 +304,8 @@ sqlite3_statement_backend::load_rowset(int totalRows)
             }
         }
     }
-    // if we read less than requested then shrink the vector
-    dataCache_.resize(i);
+    // if we read less than requested then only the first rows are valid
+    dataCache_.set_size(i);
 
     return retVal;
 }
@@ -243,7 +340,88 @@ sqlite3_statement_backend::load_one()
     return retVal;
 }
 
-// Execute statements once for every row of useData
+namespace // anonymous
+{
+
+// Wraps the execution of a bulk operation outside of any transaction in a
+// savepoint which is released, committing the changes, every batchSize rows.
+// If an exception happens, the changes done since the last release are rolled
+// back and only the number of the committed rows is reported as affected.
+class bulk_savepoint
+{
+public:
+    bulk_savepoint(sqlite3_session_backend &session, int batchSize,
+                   long long &rowsAffected)
+        : session_(session), batchSize_(batchSize), rows_(0),
+          rowsAffected_(rowsAffected), committed_(0), active_(false)
+    {
+        if (batchSize_ > 0 && sqlite3_get_autocommit(session_.conn_))
+        {
+            session_.savepoint(name());
+            active_ = true;
+        }
+    }
+
+    ~bulk_savepoint()
+    {
+        if (!active_)
+            return;
+
+        try
+        {
+            session_.rollback_to_savepoint(name());
+            session_.release_savepoint(name());
+        }
+        catch (...)
+        {
+            // don't hide the original exception
+        }
+
+        rowsAffected_ = committed_;
+    }
+
+    // Must be called after each successfully executed row with the total
+    // number of rows affected so far.
+    void row_done(long long rowsAffectedSoFar)
+    {
+        if (!active_ || ++rows_ % batchSize_ != 0)
+            return;
+
+        session_.release_savepoint(name());
+        committed_ = rowsAffectedSoFar;
+
+        active_ = false;
+        session_.savepoint(name());
+        active_ = true;
+    }
+
+    // Must be called once all rows are successfully executed.
+    void commit()
+    {
+        if (!active_)
+            return;
+
+        active_ = false;
+        session_.release_savepoint(name());
+    }
+
+private:
+    static char const *name() { return "soci_bulk"; }
+
+    sqlite3_session_backend &session_;
+    int const batchSize_;
+    int rows_;
+    long long &rowsAffected_;
+    long long committed_;
+    bool active_;
+
+    SOCI_NOT_COPYABLE(bulk_savepoint)
+};
+
+} // namespace anonymous
+
+// Execute statements once for every row of the vector use elements, or just
+// once if there are only the standard ones
 statement_backend::exec_fetch_result
 sqlite3_statement_backend::bind_and_execute(int number)
 {
@@ -253,16 +431,26 @@ sqlite3_statement_backend::bind_and_execute(int number)
 
     rowsAffectedBulk_ = -1;
 
-    int const rows = static_cast<int>(useData_.size());
+    int const rows = vectorUses_.empty()
+                        ? static_cast<int>(useData_.size())
+                        : static_cast<int>(vectorUses_.front()->size());
+
+    bulk_savepoint batch(session_, rows > 1 ? bulkBatchSize_ : 0,
+                         rowsAffectedBulk_);
+
     for (int row = 0; row < rows; ++row)
     {
         sqlite3_reset(stmt_);
 
-        int const totalPositions = static_cast<int>(useData_[0].size());
+        // Standard use elements, if any, only have a single row and are
+        // combined with the vector ones only if they have a single row too.
+        int const totalPositions = useData_.empty()
+                                    ? 0
+                                    : static_cast<int>(useData_[0].size());
         for (int pos = 1; pos <= totalPositions; ++pos)
         {
             int bindRes = SQLITE_OK;
-            const sqlite3_column &col = useData_[row][pos-1];
+            const sqlite3_column &col = useData_[0][pos-1];
             if (col.isNull_)
             {
                 bindRes = sqlite3_bind_null(stmt_, pos);
@@ -309,6 +497,21 @@ sqlite3_statement_backend::bind_and_execute(int number)
             }
         }
 
+        for (std::vector<sqlite3_vector_use_type_backend *>::const_iterator
+                it = vectorUses_.begin(); it != vectorUses_.end(); ++it)
+        {
+            try
+            {
+                (*it)->bind_row(static_cast<std::size_t>(row));
+            }
+            catch (...)
+            {
+                // preserve the number of rows affected so far.
+                rowsAffectedBulk_ = rowsAffectedBulkTemp;
+                throw;
+            }
+        }
+
         // Handle the case where there are both into and use elements
         // in the same query and one of the into binds to a vector object.
         if (1 == rows && number != rows)
@@ -319,12 +522,26 @@ sqlite3_statement_backend::bind_and_execute(int number)
         databaseReady_=true; // Mark sqlite engine is ready to perform sqlite3_step
         retVal = load_one(); // execute each bound line
         rowsAffectedBulkTemp += get_affected_rows();
+
+        batch.row_done(rowsAffectedBulkTemp);
     }
 
+    batch.commit();
+
     rowsAffectedBulk_ = rowsAffectedBulkTemp;
     return retVal;
 }
 
+void sqlite3_statement_backend::set_bulk_batch_size(int size)
+{
+    if (size < 0)
+    {
+        throw soci_error("Bulk batch size can't be negative");
+    }
+
+    bulkBatchSize_ = size;
+}
+
 statement_backend::exec_fetch_result
 sqlite3_statement_backend::execute(int number)
 {
@@ -338,7 +555,7 @@ sqlite3_statement_backend::execute(int number)
 
     statement_backend::exec_fetch_result retVal = ef_no_data;
 
-    if (useData_.empty() == false)
+    if (useData_.empty() == false || vectorUses_.empty() == false)
     {
            retVal = bind_and_execute(number);
     }
@@ -14,6 +14,7 @@
 #include "soci-dtocstr.h"
 #include "soci-exchange-cast.h"
 #include "soci/blob.h"
+#include "soci/exchange-stats.h"
 #include "soci/rowid.h"
 #include "soci/soci-platform.h"
 #include "soci/sqlite3/soci-sqlite3.h"
@@ -37,6 +38,11 @@ void sqlite3_vector_into_type_backend::define_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+
+    std::vector<sqlite3_vector_into_type_backend *> &intos = statement_.vectorIntos_;
+    if (intos.size() < static_cast<std::size_t>(position_))
+        intos.resize(position_, NULL);
+    intos[position_ - 1] = this;
 }
 
 void sqlite3_vector_into_type_backend::pre_fetch()
@@ -116,8 +122,142 @@ void set_number_in_vector(void *p, int idx, const sqlite3_column &col)
     };
 }
 
+template <typename T>
+T& get_in_vector(void* p, std::size_t indx)
+{
+    return (*static_cast<std::vector<T>*>(p))[indx];
+}
+
+// Retrieve the value of a numeric column in the same way as load_rowset()
+// does it when storing it in the row cache.
+template <typename T>
+T get_column_number(sqlite_api::sqlite3_stmt* stmt, int pos, data_type colType)
+{
+    switch (colType)
+    {
+        case dt_double:
+            return static_cast<T>(sqlite_api::sqlite3_column_double(stmt, pos));
+
+        case dt_integer:
+            return static_cast<T>(sqlite_api::sqlite3_column_int(stmt, pos));
+
+        default:
+            return static_cast<T>(sqlite_api::sqlite3_column_int64(stmt, pos));
+    }
+}
+
 } // namespace anonymous
 
+bool sqlite3_vector_into_type_backend::prepare_direct_fetch(data_type colType,
+                                                            std::size_t rows)
+{
+    using namespace details;
+
+    fetchedDirectly_ = false;
+
+    if (size() < rows)
+        return false;
+
+    // Only handle the conversions which don't need any intermediate storage
+    // here, all the others are done by post_fetch() using the cached rows.
+    switch (colType)
+    {
+        case dt_double:
+        case dt_integer:
+        case dt_long_long:
+        case dt_unsigned_long_long:
+            switch (type_)
+            {
+                case x_short:
+                case x_integer:
+                case x_long_long:
+                case x_unsigned_long_long:
+                case x_double:
+                    fetchedDirectly_ = true;
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        case dt_date:
+        case dt_string:
+        case dt_blob:
+            fetchedDirectly_ = type_ == x_stdstring;
+            break;
+
+        case dt_xml:
+            break;
+    }
+
+    if (fetchedDirectly_)
+        directInds_.resize(rows);
+
+    return fetchedDirectly_;
+}
+
+void sqlite3_vector_into_type_backend::fetch_directly(std::size_t row)
+{
+    using namespace details;
+
+    sqlite_api::sqlite3_stmt * const stmt = statement_.stmt_;
+    int const pos = position_ - 1;
+
+    // Note that the values retrieved here must be the same as the ones stored
+    // in the row cache by sqlite3_statement_backend::load_rowset() and then
+    // converted by post_fetch().
+    if (sqlite_api::sqlite3_column_type(stmt, pos) == SQLITE_NULL)
+    {
+        directInds_[row] = i_null;
+        return;
+    }
+
+    directInds_[row] = i_ok;
+
+    sqlite3_column_info const &coldef = statement_.columns_[pos];
+    switch (type_)
+    {
+        case x_stdstring:
+        {
+            const char *text = reinterpret_cast<const char*>(
+                sqlite_api::sqlite3_column_text(stmt, pos));
+            std::size_t const bytes = sqlite_api::sqlite3_column_bytes(stmt, pos);
+            get_in_vector<std::string>(data_, row).assign(text, bytes);
+            count_bytes_copied(bytes);
+            break;
+        }
+
+        case x_short:
+            get_in_vector<exchange_type_traits<x_short>::value_type>(data_, row)
+                = get_column_number<exchange_type_traits<x_short>::value_type>(stmt, pos, coldef.type_);
+            break;
+
+        case x_integer:
+            get_in_vector<exchange_type_traits<x_integer>::value_type>(data_, row)
+                = get_column_number<exchange_type_traits<x_integer>::value_type>(stmt, pos, coldef.type_);
+            break;
+
+        case x_long_long:
+            get_in_vector<exchange_type_traits<x_long_long>::value_type>(data_, row)
+                = get_column_number<exchange_type_traits<x_long_long>::value_type>(stmt, pos, coldef.type_);
+            break;
+
+        case x_unsigned_long_long:
+            get_in_vector<exchange_type_traits<x_unsigned_long_long>::value_type>(data_, row)
+                = get_column_number<exchange_type_traits<x_unsigned_long_long>::value_type>(stmt, pos, coldef.type_);
+            break;
+
+        case x_double:
+            get_in_vector<exchange_type_traits<x_double>::value_type>(data_, row)
+                = get_column_number<exchange_type_traits<x_double>::value_type>(stmt, pos, coldef.type_);
+            break;
+
+        default:
+            throw soci_error("Into element used with non-supported type.");
+    }
+}
+
 void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
 {
     using namespace details;
@@ -130,9 +270,27 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
     }
 
     int const endRow = static_cast<int>(statement_.dataCache_.size());
+
+    if (fetchedDirectly_)
+    {
+        // the values are already stored, only the indicators remain
+        for (int i = 0; i < endRow; ++i)
+        {
+            if (directInds_[i] == i_null && ind == NULL)
+            {
+                throw soci_error(
+                    "Null value fetched and no indicator defined.");
+            }
+
+            if (ind != NULL)
+                ind[i] = directInds_[i];
+        }
+
+        return;
+    }
     for (int i = 0; i < endRow; ++i)
     {
-        sqlite3_column &col = statement_.dataCache_[i][position_-1];
+        sqlite3_column &col = statement_.dataCache_.at(i, position_-1);
 
         if (col.isNull_)
         {
@@ -198,6 +356,7 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
                     case dt_string:
                     case dt_blob:
                         set_in_vector(data_, i, std::string(col.buffer_.constData_, col.buffer_.size_));
+                        count_bytes_copied(col.buffer_.size_);
                         break;
 
                     case dt_double:
@@ -225,6 +384,7 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
                     {
                         soci::xml_type xml;
                         xml.value = std::string(col.buffer_.constData_, col.buffer_.size_);
+                        count_bytes_copied(col.buffer_.size_);
                         set_in_vector(data_, i, xml);
                         break;
                     }
@@ -242,6 +402,7 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
                     {
                         soci::xml_type xml;
                         xml.value = std::string(col.buffer_.constData_, col.buffer_.size_);
+                        count_bytes_copied(col.buffer_.size_);
                         set_in_vector(data_, i, xml);
                         break;
                     }
@@ -302,26 +463,6 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
             default:
                 throw soci_error("Into element used with non-supported type.");
         }
-
-        // cleanup data
-        switch (col.type_)
-        {
-            case dt_date:
-            case dt_string:
-            case dt_blob:
-                delete[] col.buffer_.data_;
-                col.buffer_.data_ = NULL;
-                break;
-
-            case dt_double:
-            case dt_integer:
-            case dt_long_long:
-            case dt_unsigned_long_long:
-                break;
-
-            case dt_xml:
-                throw soci_error("XML data type is not supported");
-        }
     }
 }
 
@@ -410,6 +551,14 @@ std::size_t sqlite3_vector_into_type_backend::size()
 
 void sqlite3_vector_into_type_backend::clean_up()
 {
+    std::vector<sqlite3_vector_into_type_backend *> &intos = statement_.vectorIntos_;
+    if (position_ > 0 && intos.size() >= static_cast<std::size_t>(position_)
+            && intos[position_ - 1] == this)
+    {
+        intos[position_ - 1] = NULL;
+    }
+
+    fetchedDirectly_ = false;
 }
 
 } // namespace soci
@@ -12,11 +12,14 @@
 #include "soci-dtocstr.h"
 #include "common.h"
 // std
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <limits>
 #include <sstream>
+#include <vector>
 
 
 using namespace soci;
@@ -38,6 +41,8 @@ void sqlite3_vector_use_type_backend::bind_by_pos(int & position,
     position_ = position++;
 
     statement_.boundByPos_ = true;
+
+    register_with_statement();
 }
 
 void sqlite3_vector_use_type_backend::bind_by_name(std::string const & name,
@@ -55,7 +60,7 @@ void sqlite3_vector_use_type_backend::bind_by_name(std::string const & name,
     name_ = ":" + name;
 
     statement_.reset_if_needed();
-    position_ = sqlite3_bind_parameter_index(statement_.stmt_, name_.c_str());
+    position_ = sqlite_api::sqlite3_bind_parameter_index(statement_.stmt_, name_.c_str());
 
     if (0 == position_)
     {
@@ -64,99 +69,113 @@ void sqlite3_vector_use_type_backend::bind_by_name(std::string const & name,
         throw soci_error(ss.str());
     }
     statement_.boundByName_ = true;
+
+    register_with_statement();
 }
 
-void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
+void sqlite3_vector_use_type_backend::register_with_statement()
 {
-    std::size_t const vsize = size();
+    std::vector<sqlite3_vector_use_type_backend *> &uses = statement_.vectorUses_;
+    if (std::find(uses.begin(), uses.end(), this) == uses.end())
+        uses.push_back(this);
+}
 
-    // make sure that useData can hold enough rows
-    if (statement_.useData_.size() != vsize)
-        statement_.useData_.resize(vsize);
+void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
+{
+    // nothing is copied here, the data is bound directly from the vector
+    // for each row by bind_row()
+    ind_ = ind;
+}
 
-    int const pos = position_ - 1;
+namespace // anonymous
+{
 
-    for (size_t i = 0; i != vsize; ++i)
-    {
-        // make sure that each row can accomodate the number of columns
-        if (statement_.useData_[i].size() < static_cast<std::size_t>(position_))
-            statement_.useData_[i].resize(position_);
+template <typename T>
+T const& get_in_vector(void* p, std::size_t indx)
+{
+    return (*static_cast<std::vector<T>*>(p))[indx];
+}
 
-        sqlite3_column &col = statement_.useData_[i][pos];
+} // namespace anonymous
 
-        // the data in vector can be either i_ok or i_null
-        if (ind != NULL && ind[i] == i_null)
-        {
-            col.isNull_ = true;
-            col.buffer_.data_ = NULL;
-            continue;
-        }
+void sqlite3_vector_use_type_backend::bind_row(std::size_t row)
+{
+    sqlite_api::sqlite3_stmt * const stmt = statement_.stmt_;
 
-        col.isNull_ = false;
+    int res = SQLITE_OK;
 
+    // the data in vector can be either i_ok or i_null
+    if (ind_ != NULL && ind_[row] == i_null)
+    {
+        res = sqlite_api::sqlite3_bind_null(stmt, position_);
+    }
+    else
+    {
         switch (type_)
         {
             case x_char:
-                col.type_ = dt_string;
-                col.buffer_.constData_ = &(*static_cast<std::vector<exchange_type_traits<x_char>::value_type> *>(data_))[i];
-                col.buffer_.size_ = 1;
+                res = sqlite_api::sqlite3_bind_text(stmt, position_,
+                    &get_in_vector<exchange_type_traits<x_char>::value_type>(data_, row),
+                    1, SQLITE_STATIC);
                 break;
 
             case x_stdstring:
             {
-                std::string &s = (*static_cast<std::vector<exchange_type_traits<x_stdstring>::value_type> *>(data_))[i];
-                col.type_ = dt_string;
-                col.buffer_.constData_ = s.c_str();
-                col.buffer_.size_ = s.size();
+                std::string const &str =
+                    get_in_vector<exchange_type_traits<x_stdstring>::value_type>(data_, row);
+                res = sqlite_api::sqlite3_bind_text(stmt, position_, str.c_str(),
+                    static_cast<int>(str.size()), SQLITE_STATIC);
                 break;
             }
 
             case x_short:
-                col.type_ = dt_integer;
-                col.int32_ = (*static_cast<std::vector<exchange_type_traits<x_short>::value_type> *>(data_))[i];
+                res = sqlite_api::sqlite3_bind_int(stmt, position_,
+                    get_in_vector<exchange_type_traits<x_short>::value_type>(data_, row));
                 break;
 
             case x_integer:
-                col.type_ = dt_integer;
-                col.int32_ = (*static_cast<std::vector<exchange_type_traits<x_integer>::value_type> *>(data_))[i];
+                res = sqlite_api::sqlite3_bind_int(stmt, position_,
+                    get_in_vector<exchange_type_traits<x_integer>::value_type>(data_, row));
                 break;
 
             case x_long_long:
-                col.type_ = dt_long_long;
-                col.int64_ = (*static_cast<std::vector<exchange_type_traits<x_long_long>::value_type> *>(data_))[i];
+                res = sqlite_api::sqlite3_bind_int64(stmt, position_,
+                    get_in_vector<exchange_type_traits<x_long_long>::value_type>(data_, row));
                 break;
 
             case x_unsigned_long_long:
-                col.type_ = dt_long_long;
-                col.int64_ = (*static_cast<std::vector<exchange_type_traits<x_unsigned_long_long>::value_type> *>(data_))[i];
+                res = sqlite_api::sqlite3_bind_int64(stmt, position_,
+                    static_cast<sqlite_api::sqlite3_int64>(
+                        get_in_vector<exchange_type_traits<x_unsigned_long_long>::value_type>(data_, row)));
                 break;
 
             case x_double:
-                col.type_ = dt_double;
-                col.double_ = (*static_cast<std::vector<exchange_type_traits<x_double>::value_type> *>(data_))[i];
+                res = sqlite_api::sqlite3_bind_double(stmt, position_,
+                    get_in_vector<exchange_type_traits<x_double>::value_type>(data_, row));
                 break;
 
             case x_stdtm:
             {
-                std::tm &tm = (*static_cast<std::vector<exchange_type_traits<x_stdtm>::value_type> *>(data_))[i];
-                static const size_t bufSize = 20;
-
-                col.type_ = dt_date;
-                col.buffer_.data_ = new char[bufSize];
-                col.buffer_.size_
-                    = snprintf(col.buffer_.data_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
-                        tm.tm_hour, tm.tm_min, tm.tm_sec
-                    );
+                std::tm const &tm =
+                    get_in_vector<exchange_type_traits<x_stdtm>::value_type>(data_, row);
+
+                // the buffer remains valid until the next row is bound
+                int const len = snprintf(tmBuffer_, sizeof(tmBuffer_),
+                    "%d-%02d-%02d %02d:%02d:%02d",
+                    tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                    tm.tm_hour, tm.tm_min, tm.tm_sec);
+                res = sqlite_api::sqlite3_bind_text(stmt, position_, tmBuffer_,
+                    (std::min)(len, static_cast<int>(sizeof(tmBuffer_)) - 1),
+                    SQLITE_STATIC);
                 break;
             }
 
             case x_xmltype:
             {
-                soci::xml_type &xml = (*static_cast<std::vector<exchange_type_traits<x_xmltype>::value_type> *>(data_))[i];
-                col.type_ = dt_string;
-                col.buffer_.constData_ = xml.value.c_str();
-                col.buffer_.size_ = xml.value.size();
+                soci::xml_type const &xml =
+                    get_in_vector<exchange_type_traits<x_xmltype>::value_type>(data_, row);
+                res = sqlite_api::sqlite3_bind_text(stmt, position_, xml.value.c_str(),
+                    static_cast<int>(xml.value.size()), SQLITE_STATIC);
                 break;
             }
 
@@ -165,6 +184,11 @@ void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
                     "Use vector element used with non-supported type.");
         }
     }
+
+    if (SQLITE_OK != res)
+    {
+        throw sqlite3_soci_error("Failure to bind on bulk operations", res);
+    }
 }
 
 std::size_t sqlite3_vector_use_type_backend::size()
@@ -209,19 +233,8 @@ std::size_t sqlite3_vector_use_type_backend::size()
 
 void sqlite3_vector_use_type_backend::clean_up()
 {
-    if (type_ != x_stdtm)
-        return;
-
-    int const pos = position_ - 1;
-
-    for (sqlite3_recordset::iterator iter = statement_.useData_.begin(), last = statement_.useData_.end();
-        iter != last; ++iter)
-    {
-        sqlite3_column &col = (*iter)[pos];
-
-        if (col.isNull_)
-            continue;
+    std::vector<sqlite3_vector_use_type_backend *> &uses = statement_.vectorUses_;
+    uses.erase(std::remove(uses.begin(), uses.end(), this), uses.end());
 
-        delete[] col.buffer_.data_;
-    }
+    ind_ = NULL;
 }
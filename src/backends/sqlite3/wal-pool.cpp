@@ -0,0 +1,66 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SQLITE3_SOURCE
+#include "soci/sqlite3/soci-sqlite3.h"
+#include "soci/session.h"
+#include "soci/into.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <string>
+
+using namespace soci;
+
+namespace // anonymous
+{
+
+// Make the connection string suitable for appending more options to it.
+std::string normalize_connect_string(std::string const & connectString)
+{
+    // A string without any "=" is just the database name.
+    if (connectString.find('=') == std::string::npos)
+        return "db=\"" + connectString + "\"";
+
+    return connectString;
+}
+
+} // namespace anonymous
+
+sqlite3_wal_pool::sqlite3_wal_pool(std::string const & connectString,
+                                   std::size_t readers, long long mmapSize)
+    : writer_(1), readers_(readers)
+{
+    std::string connstr = normalize_connect_string(connectString);
+    if (mmapSize > 0)
+    {
+        std::ostringstream oss;
+        oss << connstr << " mmap_size=" << mmapSize;
+        connstr = oss.str();
+    }
+
+    // WAL mode is persistent, so it's enough to enable it once for the
+    // database, but it must be done before opening the read-only connections.
+    session & writer = writer_.at(0);
+    writer.open(sqlite3, connstr + " journal_mode=wal");
+
+    std::string mode;
+    writer << "pragma journal_mode", into(mode);
+    std::transform(mode.begin(), mode.end(), mode.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(c)); });
+    if (mode != "wal")
+    {
+        throw soci_error("Failed to enable WAL journal mode for \"" +
+                         connectString + "\" (in-memory databases can't be "
+                         "used with sqlite3_wal_pool).");
+    }
+
+    for (std::size_t i = 0; i != readers; ++i)
+    {
+        readers_.at(i).open(sqlite3, connstr + " readonly=1");
+    }
+}
@@ -0,0 +1,193 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/exchange-arena.h"
+#include "soci/exchange-stats.h"
+
+#include <cstddef>
+#include <new>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+std::size_t const max_alignment = alignof(std::max_align_t);
+
+std::size_t align_size(std::size_t size)
+{
+    return (size + max_alignment - 1) / max_alignment * max_alignment;
+}
+
+// Each allocated element is preceded by this header, padded to the maximal
+// alignment, which allows to find the arena it was allocated from, if any.
+struct object_header
+{
+    exchange_arena * arena_;
+};
+
+std::size_t const object_header_size = align_size(sizeof(object_header));
+
+// The arena used for allocating the new elements in the current thread.
+thread_local exchange_arena * current_arena = NULL;
+
+} // namespace anonymous
+
+struct exchange_arena::chunk
+{
+    chunk * next_;
+    std::size_t size_;
+
+    static std::size_t header_size() { return align_size(sizeof(chunk)); }
+
+    char * data() { return reinterpret_cast<char *>(this) + header_size(); }
+};
+
+exchange_arena::exchange_arena()
+    : current_(NULL), chunks_(NULL), used_(0), objects_(0)
+{
+}
+
+exchange_arena::~exchange_arena()
+{
+    while (chunks_)
+    {
+        chunk * const next = chunks_->next_;
+        ::operator delete(chunks_);
+        chunks_ = next;
+    }
+}
+
+std::size_t exchange_arena::get_heap_chunks_count() const
+{
+    std::size_t count = 0;
+    for (chunk * c = chunks_; c; c = c->next_)
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+void * exchange_arena::allocate(std::size_t size)
+{
+    if (!current_)
+    {
+        if (used_ + size <= buffer_size)
+        {
+            void * const p = buffer_ + used_;
+            used_ += size;
+            return p;
+        }
+    }
+    else if (used_ + size <= current_->size_)
+    {
+        void * const p = current_->data() + used_;
+        used_ += size;
+        return p;
+    }
+
+    // Switch to the next chunk, reusing the existing one if it's big enough.
+    chunk * const next = current_ ? current_->next_ : chunks_;
+    if (next && size <= next->size_)
+    {
+        current_ = next;
+    }
+    else
+    {
+        std::size_t const chunkSize = size < 4096 ? 4096 : size;
+
+        chunk * const c = static_cast<chunk *>(
+            ::operator new(chunk::header_size() + chunkSize));
+        count_allocation(chunk::header_size() + chunkSize);
+        c->size_ = chunkSize;
+        c->next_ = next;
+
+        if (current_)
+        {
+            current_->next_ = c;
+        }
+        else
+        {
+            chunks_ = c;
+        }
+
+        current_ = c;
+    }
+
+    used_ = size;
+    return current_->data();
+}
+
+void exchange_arena::release()
+{
+    current_ = NULL;
+    used_ = 0;
+}
+
+void * exchange_arena::allocate_object(std::size_t size)
+{
+    std::size_t const totalSize = object_header_size + align_size(size);
+
+    exchange_arena * const arena = current_arena;
+
+    void * p;
+    if (arena)
+    {
+        p = arena->allocate(totalSize);
+    }
+    else
+    {
+        p = ::operator new(totalSize);
+        count_allocation(totalSize);
+    }
+
+    static_cast<object_header *>(p)->arena_ = arena;
+    if (arena)
+    {
+        ++arena->objects_;
+    }
+
+    return static_cast<char *>(p) + object_header_size;
+}
+
+void exchange_arena::deallocate_object(void * p)
+{
+    if (!p)
+    {
+        return;
+    }
+
+    void * const raw = static_cast<char *>(p) - object_header_size;
+
+    exchange_arena * const arena = static_cast<object_header *>(raw)->arena_;
+    if (arena)
+    {
+        // The memory of the individual elements is never reused, but all of
+        // it can be reused once all elements are gone.
+        if (--arena->objects_ == 0)
+        {
+            arena->release();
+        }
+    }
+    else
+    {
+        ::operator delete(raw);
+    }
+}
+
+exchange_arena_scope::exchange_arena_scope(exchange_arena * arena)
+    : previous_(current_arena)
+{
+    current_arena = arena;
+}
+
+exchange_arena_scope::~exchange_arena_scope()
+{
+    current_arena = previous_;
+}
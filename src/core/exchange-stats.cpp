@@ -0,0 +1,43 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/exchange-stats.h"
+
+#ifdef SOCI_HAVE_INSTRUMENTATION
+
+using namespace soci;
+using namespace soci::details;
+
+exchange_stats & soci::details::get_thread_exchange_stats()
+{
+    thread_local exchange_stats stats;
+
+    return stats;
+}
+
+namespace // anonymous
+{
+
+allocation_hook allocationHook_ = NULL;
+
+} // namespace anonymous
+
+void soci::details::set_allocation_hook(allocation_hook hook)
+{
+    allocationHook_ = hook;
+}
+
+exchange_stats soci::details::get_thread_exchange_stats_snapshot()
+{
+    exchange_stats stats = get_thread_exchange_stats();
+    if (allocationHook_)
+        allocationHook_(stats.allocations, stats.bytesAllocated);
+
+    return stats;
+}
+
+#endif // SOCI_HAVE_INSTRUMENTATION
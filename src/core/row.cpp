@@ -7,25 +7,100 @@
 
 #define SOCI_SOURCE
 #include "soci/row.h"
+#include "soci/exchange-stats.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cctype>
+#include <ctime>
+#include <new>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 using namespace soci;
 using namespace details;
 
+namespace // anonymous
+{
+
+// Check that the values of the columns of the given type can be stored in a
+// row, i.e. in a value_holder.
+void check_data_type(data_type dt)
+{
+    switch (dt)
+    {
+        case dt_string:
+        case dt_blob:
+        case dt_xml:
+        case dt_date:
+        case dt_double:
+        case dt_integer:
+        case dt_long_long:
+        case dt_unsigned_long_long:
+            return;
+    }
+
+    std::ostringstream msg;
+    msg << "db column type " << dt
+        << " not supported for dynamic selects";
+    throw soci_error(msg.str());
+}
+
+} // namespace anonymous
+
 row::row()
-    : uppercaseColumnNames_(false)
+    : values_(NULL)
+    , indicators_(NULL)
+    , numValues_(0)
+    , descriptionId_(0)
+    , uppercaseColumnNames_(false)
     , currentPos_(0)
 {}
 
+row::row(row &&other)
+    : values_(NULL)
+    , indicators_(NULL)
+    , numValues_(0)
+    , descriptionId_(0)
+    , uppercaseColumnNames_(false)
+    , currentPos_(0)
+{
+    *this = std::move(other);
+}
+
 row::~row()
 {
     clean_up();
 }
 
+row &row::operator=(row &&other)
+{
+    if (this != &other)
+    {
+        // The values in the storage must be destroyed before releasing it.
+        clean_up();
+
+        columns_ = std::move(other.columns_);
+        storage_ = std::move(other.storage_);
+        values_ = other.values_;
+        indicators_ = other.indicators_;
+        numValues_ = other.numValues_;
+        index_ = std::move(other.index_);
+        descriptionId_ = other.descriptionId_;
+        uppercaseColumnNames_ = other.uppercaseColumnNames_;
+        currentPos_ = other.currentPos_;
+
+        // The values are owned by this row now.
+        other.values_ = NULL;
+        other.indicators_ = NULL;
+        other.numValues_ = 0;
+    }
+
+    return *this;
+}
+
 void row::uppercase_column_names(bool forceToUpper)
 {
     uppercaseColumnNames_ = forceToUpper;
@@ -35,51 +110,86 @@ void row::add_properties(column_properties const &cp)
 {
     columns_.push_back(cp);
 
-    std::string columnName;
-    std::string const & originalName = cp.get_name();
+    column_properties& props = columns_.back();
     if (uppercaseColumnNames_)
     {
-        for (std::size_t i = 0; i != originalName.size(); ++i)
-        {
-            columnName.push_back(static_cast<char>(std::toupper(originalName[i])));
-        }
-
         // rewrite the column name in the column_properties object
         // as well to retain consistent views
+        std::string columnName = props.get_name();
+        for (std::string::iterator it = columnName.begin();
+             it != columnName.end(); ++it)
+        {
+            *it = static_cast<char>(std::toupper(static_cast<unsigned char>(*it)));
+        }
 
-        columns_[columns_.size() - 1].set_name(columnName);
-    }
-    else
-    {
-        columnName = originalName;
+        props.set_name(columnName);
     }
 
-    index_[columnName] = columns_.size() - 1;
+    index_[props.get_name()] = columns_.size() - 1;
 }
 
 std::size_t row::size() const
 {
-    return holders_.size();
+    return numValues_;
+}
+
+void row::allocate_storage()
+{
+    // Store the values of all columns followed by all their indicators in a
+    // single block. Memory allocated by new[] is suitably aligned for
+    // value_holder and its size is a multiple of the alignment of indicator.
+    std::size_t const numcols = columns_.size();
+    for (std::size_t i = 0; i != numcols; ++i)
+    {
+        check_data_type(columns_[i].get_data_type());
+    }
+
+    std::size_t const storageSize
+        = numcols * (sizeof(value_holder) + sizeof(indicator)) + 1;
+    storage_.reset(new char[storageSize]);
+    count_allocation(storageSize);
+
+    values_ = reinterpret_cast<value_holder*>(storage_.get());
+    indicators_ = reinterpret_cast<indicator*>(values_ + numcols);
+
+    for (std::size_t i = 0; i != numcols; ++i)
+    {
+        new (&values_[i]) value_holder(columns_[i].get_data_type());
+        indicators_[i] = i_ok;
+    }
+
+    numValues_ = numcols;
+
+    // Invalidate all the handles created for the previous description.
+    static std::atomic<unsigned long> lastDescriptionId(0);
+    descriptionId_ = ++lastDescriptionId;
 }
 
 void row::clean_up()
 {
-    std::size_t const hsize = holders_.size();
-    for (std::size_t i = 0; i != hsize; ++i)
+    for (std::size_t i = 0; i != numValues_; ++i)
     {
-        delete holders_[i];
-        delete indicators_[i];
+        values_[i].~value_holder();
     }
 
+    storage_.reset();
+    values_ = NULL;
+    indicators_ = NULL;
+    numValues_ = 0;
+
     columns_.clear();
-    holders_.clear();
-    indicators_.clear();
     index_.clear();
+    descriptionId_ = 0;
 }
 
 indicator row::get_indicator(std::size_t pos) const
 {
-    return *indicators_.at(pos);
+    if (pos >= numValues_)
+    {
+        throw std::out_of_range("Invalid column position");
+    }
+
+    return indicators_[pos];
 }
 
 indicator row::get_indicator(std::string const &name) const
@@ -99,7 +209,8 @@ column_properties const & row::get_properties(std::string const &name) const
 
 std::size_t row::find_column(std::string const &name) const
 {
-    std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
+    std::unordered_map<std::string, std::size_t>::const_iterator
+        it = index_.find(name);
     if (it == index_.end())
     {
         std::ostringstream msg;
@@ -109,3 +220,8 @@ std::size_t row::find_column(std::string const &name) const
 
     return it->second;
 }
+
+column_handle row::get_column_handle(std::string const &name) const
+{
+    return column_handle(find_column(name), descriptionId_);
+}
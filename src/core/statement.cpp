@@ -11,6 +11,7 @@
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 #include "soci/values.h"
+#include "soci/typed-statement.h"
 #include "soci-compiler.h"
 #include <ctime>
 #include <cctype>
@@ -18,18 +19,69 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // anonymous
+{
+
+// Adds the work done in the current thread during the lifetime of this object
+// to the statement statistics, incrementing the given call counter too.
+class exchange_stats_collector
+{
+public:
+    exchange_stats_collector(exchange_stats & stats,
+                             std::size_t exchange_stats::* calls)
+#ifdef SOCI_HAVE_INSTRUMENTATION
+        : stats_(stats), start_(get_thread_exchange_stats_snapshot())
+    {
+        if (calls)
+            ++(stats_.*calls);
+    }
+
+    ~exchange_stats_collector()
+    {
+        exchange_stats const end = get_thread_exchange_stats_snapshot();
+
+        stats_.exchangeCalls += end.exchangeCalls - start_.exchangeCalls;
+        stats_.allocations += end.allocations - start_.allocations;
+        stats_.bytesAllocated += end.bytesAllocated - start_.bytesAllocated;
+        stats_.bytesCopied += end.bytesCopied - start_.bytesCopied;
+    }
+
+private:
+    exchange_stats & stats_;
+    exchange_stats const start_;
+#else // !SOCI_HAVE_INSTRUMENTATION
+    {
+        SOCI_UNUSED(stats);
+        SOCI_UNUSED(calls);
+    }
+#endif // SOCI_HAVE_INSTRUMENTATION
+
+    SOCI_NOT_COPYABLE(exchange_stats_collector)
+};
+
+} // namespace anonymous
+
 
 statement_impl::statement_impl(session & s)
     : session_(s), refCount_(1), row_(0),
       fetchSize_(1), initialFetchSize_(1),
-      alreadyDescribed_(false)
+      intosPlan_(&intos_), intosHaveVectors_(false), usesHaveVectors_(false),
+      exchangeHooks_(0), planOutdated_(true),
+      expectedColumns_(NULL), expectedColumnsCount_(0),
+      alreadyDescribed_(false), asyncNum_(-1)
 {
     backEnd_ = s.make_statement_backend();
+
+    set_exchange_arena();
 }
 
 statement_impl::statement_impl(prepare_temp_type const & prep)
     : session_(prep.get_prepare_info()->session_),
-      refCount_(1), row_(0), fetchSize_(1), alreadyDescribed_(false)
+      refCount_(1), row_(0), fetchSize_(1),
+      intosPlan_(&intos_), intosHaveVectors_(false), usesHaveVectors_(false),
+      exchangeHooks_(0), planOutdated_(true),
+      expectedColumns_(NULL), expectedColumnsCount_(0),
+      alreadyDescribed_(false), asyncNum_(-1)
 {
     backEnd_ = session_.make_statement_backend();
 
@@ -39,6 +91,8 @@ statement_impl::statement_impl(prepare_temp_type const & prep)
     intos_.swap(prepInfo->intos_);
     uses_.swap(prepInfo->uses_);
 
+    set_exchange_arena();
+
     // allocate handle
     alloc();
 
@@ -57,6 +111,13 @@ statement_impl::statement_impl(prepare_temp_type const & prep)
     define_and_bind();
 }
 
+void statement_impl::set_exchange_arena()
+{
+    intos_.set_arena(&arena_);
+    uses_.set_arena(&arena_);
+    intosForRow_.set_arena(&arena_);
+}
+
 statement_impl::~statement_impl()
 {
     clean_up();
@@ -89,6 +150,7 @@ void statement_impl::bind(values & values)
                 (*it)->bind(*this, position);
                 uses_.push_back(*it);
                 indicators_.push_back(values.indicators_[cnt]);
+                planOutdated_ = true;
             }
             else
             {
@@ -115,6 +177,7 @@ void statement_impl::bind(values & values)
                         (*it)->bind(*this, position);
                         uses_.push_back(*it);
                         indicators_.push_back(values.indicators_[cnt]);
+                        planOutdated_ = true;
                         // Ok we found it, done
                         break;
                     }
@@ -177,6 +240,10 @@ void statement_impl::bind_clean_up()
 
     row_ = NULL;
     alreadyDescribed_ = false;
+
+    intosWithRow_.clear();
+    intosPlan_ = &intos_;
+    planOutdated_ = true;
 }
 
 void statement_impl::clean_up()
@@ -227,6 +294,75 @@ void statement_impl::define_and_bind()
     {
         uses_[i]->bind(*this, bindPosition);
     }
+
+    planOutdated_ = true;
+}
+
+void statement_impl::update_exchange_plan()
+{
+    // Only build a separate list if there are elements injected by the row
+    // description, to avoid allocating memory for it in the common case.
+    if (intosForRow_.empty())
+    {
+        intosPlan_ = &intos_;
+    }
+    else
+    {
+        // Note that clearing the vector keeps its capacity, so it's only
+        // reallocated if more elements are added.
+        intosWithRow_.clear();
+        intosWithRow_.insert(intosWithRow_.end(),
+                             intosForRow_.begin(), intosForRow_.end());
+        intosWithRow_.insert(intosWithRow_.end(),
+                             intos_.begin(), intos_.end());
+        intosPlan_ = &intosWithRow_;
+    }
+
+    intosHaveVectors_ = false;
+    bool intosHaveOwnHooks = false;
+    std::size_t const isize = intosPlan_->size();
+    for (std::size_t i = 0; i != isize; ++i)
+    {
+        into_type_base * const into = (*intosPlan_)[i];
+        if (into->is_vector())
+        {
+            intosHaveVectors_ = true;
+        }
+        if (into->has_own_hooks())
+        {
+            intosHaveOwnHooks = true;
+        }
+    }
+
+    usesHaveVectors_ = false;
+    bool usesHaveOwnHooks = false;
+    std::size_t const usize = uses_.size();
+    for (std::size_t i = 0; i != usize; ++i)
+    {
+        if (uses_[i]->is_vector())
+        {
+            usesHaveVectors_ = true;
+        }
+        if (uses_[i]->has_own_hooks())
+        {
+            usesHaveOwnHooks = true;
+        }
+    }
+
+    // The optional hooks must be called if either the backend or any of the
+    // elements not forwarding them to the backend needs them.
+    exchangeHooks_ = backEnd_->get_exchange_hooks();
+    if (intosHaveOwnHooks)
+    {
+        exchangeHooks_ |= statement_backend::eh_pre_exec |
+                          statement_backend::eh_pre_fetch;
+    }
+    if (usesHaveOwnHooks)
+    {
+        exchangeHooks_ |= statement_backend::eh_pre_exec;
+    }
+
+    planOutdated_ = false;
 }
 
 void statement_impl::define_for_row()
@@ -261,97 +397,208 @@ void statement_impl::undefine_and_bind()
 
 bool statement_impl::execute(bool withDataExchange)
 {
+    exchange_stats_collector collector(stats_, &exchange_stats::executes);
+
     try
     {
-        initialFetchSize_ = intos_size();
+        int const num = start_execute(withDataExchange);
 
-        if (intos_.empty() == false && initialFetchSize_ == 0)
+        return finish_execute(backEnd_->execute(num), num);
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("executing");
+    }
+}
+
+async_result statement_impl::execute_async(bool withDataExchange)
+{
+    exchange_stats_collector collector(stats_, &exchange_stats::executes);
+
+    int num = 0;
+    try
+    {
+        num = start_execute(withDataExchange);
+
+        if (backEnd_->start_async_execute(num))
         {
-            // this can happen only with into-vectors elements
-            // and is not allowed when calling execute
-            throw soci_error("Vectors of size 0 are not allowed.");
+            asyncNum_ = num;
+            return async_result(*this);
         }
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("executing");
+    }
 
-        fetchSize_ = initialFetchSize_;
+    // The backend doesn't support asynchronous execution, so just execute
+    // the statement synchronously, but report the errors in the same way.
+    try
+    {
+        return async_result(*this, execute_sync(num), std::exception_ptr());
+    }
+    catch (...)
+    {
+        return async_result(*this, false, std::current_exception());
+    }
+}
 
-        // pre-use should be executed before inspecting the sizes of use
-        // elements, as they can be resized in type conversion routines
+bool statement_impl::execute_sync(int num)
+{
+    try
+    {
+        return finish_execute(backEnd_->execute(num), num);
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("executing");
+    }
+}
 
-        pre_use();
+int statement_impl::start_execute(bool withDataExchange)
+{
+    check_not_executing_async();
 
-        std::size_t const bindSize = uses_size();
+    if (planOutdated_)
+    {
+        update_exchange_plan();
+    }
 
-        if (bindSize > 1 && fetchSize_ > 1)
-        {
-            throw soci_error(
-                 "Bulk insert/update and bulk select not allowed in same query");
-        }
+    initialFetchSize_ = intos_size();
 
-        // looks like a hack and it is - row description should happen
-        // *after* the use elements were completely prepared
-        // and *before* the into elements are touched, so that the row
-        // description process can inject more into elements for
-        // implicit data exchange
-        if (row_ != NULL && alreadyDescribed_ == false)
-        {
-            describe();
-            define_for_row();
-        }
+    if (intos_.empty() == false && initialFetchSize_ == 0)
+    {
+        // this can happen only with into-vectors elements
+        // and is not allowed when calling execute
+        throw soci_error("Vectors of size 0 are not allowed.");
+    }
 
-        int num = 0;
-        if (withDataExchange)
-        {
-            num = 1;
+    fetchSize_ = initialFetchSize_;
 
-            pre_fetch();
+    // pre-use should be executed before inspecting the sizes of use
+    // elements, as they can be resized in type conversion routines
 
-            if (static_cast<int>(fetchSize_) > num)
-            {
-                num = static_cast<int>(fetchSize_);
-            }
-            if (static_cast<int>(bindSize) > num)
-            {
-                num = static_cast<int>(bindSize);
-            }
-        }
+    pre_use();
 
-        pre_exec(num);
+    std::size_t const bindSize = uses_size();
 
-        statement_backend::exec_fetch_result res = backEnd_->execute(num);
+    if (bindSize > 1 && fetchSize_ > 1)
+    {
+        throw soci_error(
+             "Bulk insert/update and bulk select not allowed in same query");
+    }
 
-        bool gotData = false;
+    // looks like a hack and it is - row description should happen
+    // *after* the use elements were completely prepared
+    // and *before* the into elements are touched, so that the row
+    // description process can inject more into elements for
+    // implicit data exchange
+    if (row_ != NULL && alreadyDescribed_ == false)
+    {
+        describe();
+        define_for_row();
+        update_exchange_plan();
+    }
+    else if (expectedColumns_ != NULL)
+    {
+        // As with describe() above, this must be done after preparing the
+        // use elements, as some backends execute the query to describe it.
+        check_typed_columns(*backEnd_, expectedColumns_,
+                            expectedColumnsCount_);
+        expectedColumns_ = NULL;
+    }
 
-        if (res == statement_backend::ef_success)
-        {
-            // the "success" means that the statement executed correctly
-            // and for select statement this also means that some rows were read
+    int num = 0;
+    if (withDataExchange)
+    {
+        num = 1;
 
-            if (num > 0)
-            {
-                gotData = true;
+        pre_fetch();
 
-                // ensure into vectors have correct size
-                resize_intos(static_cast<std::size_t>(num));
-            }
+        if (static_cast<int>(fetchSize_) > num)
+        {
+            num = static_cast<int>(fetchSize_);
         }
-        else // res == ef_no_data
+        if (static_cast<int>(bindSize) > num)
         {
-            // the "no data" means that the end-of-rowset condition was hit
-            // but still some rows might have been read (the last bunch of rows)
-            // it can also mean that the statement did not produce any results
-
-            gotData = fetchSize_ > 1 ? resize_intos() : false;
+            num = static_cast<int>(bindSize);
         }
+    }
+
+    pre_exec(num);
+
+    return num;
+}
+
+bool statement_impl::finish_execute(statement_backend::exec_fetch_result res,
+                                    int num)
+{
+    bool gotData = false;
+
+    if (res == statement_backend::ef_success)
+    {
+        // the "success" means that the statement executed correctly
+        // and for select statement this also means that some rows were read
 
         if (num > 0)
         {
-            post_fetch(gotData, false);
+            gotData = true;
+
+            // ensure into vectors have correct size
+            resize_intos(static_cast<std::size_t>(num));
         }
+    }
+    else // res == ef_no_data
+    {
+        // the "no data" means that the end-of-rowset condition was hit
+        // but still some rows might have been read (the last bunch of rows)
+        // it can also mean that the statement did not produce any results
 
-        post_use(gotData);
+        gotData = fetchSize_ > 1 ? resize_intos() : false;
+    }
 
-        session_.set_got_data(gotData);
-        return gotData;
+    if (num > 0)
+    {
+        post_fetch(gotData, false);
+    }
+
+    post_use(gotData);
+
+    session_.set_got_data(gotData);
+    return gotData;
+}
+
+void statement_impl::check_not_executing_async() const
+{
+    if (asyncNum_ != -1)
+    {
+        throw soci_error("Statement is still being executed asynchronously.");
+    }
+}
+
+bool statement_impl::poll_async_execute(bool wait)
+{
+    try
+    {
+        return backEnd_->poll_async_execute(wait);
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("executing");
+    }
+}
+
+bool statement_impl::complete_async_execute()
+{
+    // Don't count this as another execution, but do count the work done.
+    exchange_stats_collector collector(stats_, NULL);
+
+    int const num = asyncNum_;
+    asyncNum_ = -1;
+
+    try
+    {
+        return finish_execute(backEnd_->complete_async_execute(), num);
     }
     catch (...)
     {
@@ -359,6 +606,18 @@ bool statement_impl::execute(bool withDataExchange)
     }
 }
 
+void statement_impl::cancel_async_execute()
+{
+    try
+    {
+        backEnd_->cancel_async_execute();
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("cancelling");
+    }
+}
+
 long long statement_impl::get_affected_rows()
 {
     try
@@ -373,8 +632,12 @@ long long statement_impl::get_affected_rows()
 
 bool statement_impl::fetch()
 {
+    exchange_stats_collector collector(stats_, &exchange_stats::fetches);
+
     try
     {
+        check_not_executing_async();
+
         if (fetchSize_ == 0)
         {
             truncate_intos();
@@ -382,6 +645,11 @@ bool statement_impl::fetch()
             return false;
         }
 
+        if (planOutdated_)
+        {
+            update_exchange_plan();
+        }
+
         bool gotData = false;
 
         // vectors might have been resized between fetches
@@ -449,6 +717,12 @@ std::size_t statement_impl::intos_size()
     // since their sizes are always 1 (which is the same and the primary
     // into(row) element, which has injected them)
 
+    if (!intosHaveVectors_)
+    {
+        // all elements have size 1, so there is nothing to check
+        return intos_.empty() ? 0 : 1;
+    }
+
     std::size_t intos_size = 0;
     std::size_t const isize = intos_.size();
     for (std::size_t i = 0; i != isize; ++i)
@@ -473,6 +747,11 @@ std::size_t statement_impl::intos_size()
 
 std::size_t statement_impl::uses_size()
 {
+    if (!usesHaveVectors_)
+    {
+        return uses_.empty() ? 0 : 1;
+    }
+
     std::size_t usesSize = 0;
     std::size_t const usize = uses_.size();
     for (std::size_t i = 0; i != usize; ++i)
@@ -535,16 +814,15 @@ void statement_impl::truncate_intos()
 
 void statement_impl::pre_exec(int num)
 {
-    std::size_t const isize = intos_.size();
-    for (std::size_t i = 0; i != isize; ++i)
+    if ((exchangeHooks_ & statement_backend::eh_pre_exec) == 0)
     {
-        intos_[i]->pre_exec(num);
+        return;
     }
 
-    std::size_t const ifrsize = intosForRow_.size();
-    for (std::size_t i = 0; i != ifrsize; ++i)
+    std::size_t const isize = intosPlan_->size();
+    for (std::size_t i = 0; i != isize; ++i)
     {
-        intosForRow_[i]->pre_exec(num);
+        (*intosPlan_)[i]->pre_exec(num);
     }
 
     std::size_t const usize = uses_.size();
@@ -552,21 +830,24 @@ void statement_impl::pre_exec(int num)
     {
         uses_[i]->pre_exec(num);
     }
+
+    count_exchange_calls(isize + usize);
 }
 
 void statement_impl::pre_fetch()
 {
-    std::size_t const isize = intos_.size();
-    for (std::size_t i = 0; i != isize; ++i)
+    if ((exchangeHooks_ & statement_backend::eh_pre_fetch) == 0)
     {
-        intos_[i]->pre_fetch();
+        return;
     }
 
-    std::size_t const ifrsize = intosForRow_.size();
-    for (std::size_t i = 0; i != ifrsize; ++i)
+    std::size_t const isize = intosPlan_->size();
+    for (std::size_t i = 0; i != isize; ++i)
     {
-        intosForRow_[i]->pre_fetch();
+        (*intosPlan_)[i]->pre_fetch();
     }
+
+    count_exchange_calls(isize);
 }
 
 void statement_impl::pre_use()
@@ -576,39 +857,42 @@ void statement_impl::pre_use()
     {
         uses_[i]->pre_use();
     }
+
+    count_exchange_calls(usize);
 }
 
 void statement_impl::post_fetch(bool gotData, bool calledFromFetch)
 {
-    // first iterate over intosForRow_ elements, since the Row element
-    // (which is among the intos_ elements) might depend on the
-    // values of those implicitly injected elements
+    // intosForRow_ elements come first in the plan, since the Row element
+    // (which is among the intos_ elements) might depend on the values of
+    // those implicitly injected elements
 
     std::size_t const ifrsize = intosForRow_.size();
-    for (std::size_t i = 0; i != ifrsize; ++i)
-    {
-        intosForRow_[i]->post_fetch(gotData, calledFromFetch);
-    }
-
-    std::size_t const isize = intos_.size();
-    for (std::size_t i = 0; i != isize; ++i)
+    std::size_t const isize = intosPlan_->size();
+    std::size_t i = 0;
+    try
     {
-        try
+        for (; i != isize; ++i)
         {
-            intos_[i]->post_fetch(gotData, calledFromFetch);
+            (*intosPlan_)[i]->post_fetch(gotData, calledFromFetch);
         }
-        catch (soci_error& e)
+    }
+    catch (soci_error& e)
+    {
+        // Provide the parameter number in the error message as the
+        // exceptions thrown by the backend only say what went wrong, but
+        // not where.
+        if (i >= ifrsize)
         {
-            // Provide the parameter number in the error message as the
-            // exceptions thrown by the backend only say what went wrong, but
-            // not where.
             std::ostringstream oss;
-            oss << "for the parameter number " << i + 1;
+            oss << "for the parameter number " << i - ifrsize + 1;
             e.add_context(oss.str());
-
-            throw;
         }
+
+        throw;
     }
+
+    count_exchange_calls(isize);
 }
 
 void statement_impl::post_use(bool gotData)
@@ -619,6 +903,8 @@ void statement_impl::post_use(bool gotData)
     {
         uses_[i-1]->post_use(gotData);
     }
+
+    count_exchange_calls(uses_.size());
 }
 
 namespace soci
@@ -629,39 +915,39 @@ namespace details
 // Map data_types to stock types for dynamic result set support
 
 template<>
-void statement_impl::bind_into<dt_string>()
+void statement_impl::bind_into<dt_string>(std::size_t pos)
 {
-    into_row<std::string>();
+    into_row<std::string>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_double>()
+void statement_impl::bind_into<dt_double>(std::size_t pos)
 {
-    into_row<double>();
+    into_row<double>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_integer>()
+void statement_impl::bind_into<dt_integer>(std::size_t pos)
 {
-    into_row<int>();
+    into_row<int>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_long_long>()
+void statement_impl::bind_into<dt_long_long>(std::size_t pos)
 {
-    into_row<long long>();
+    into_row<long long>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_unsigned_long_long>()
+void statement_impl::bind_into<dt_unsigned_long_long>(std::size_t pos)
 {
-    into_row<unsigned long long>();
+    into_row<unsigned long long>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_date>()
+void statement_impl::bind_into<dt_date>(std::size_t pos)
 {
-    into_row<std::tm>();
+    into_row<std::tm>(pos);
 }
 
 void statement_impl::describe()
@@ -680,39 +966,38 @@ void statement_impl::describe()
         props.set_name(columnName);
         props.set_data_type(dtype);
 
-        switch (dtype)
+        row_->add_properties(props);
+    }
+
+    // Storage for all columns is allocated at once, so the into elements can
+    // only be created after describing all of them.
+    row_->allocate_storage();
+
+    for (std::size_t i = 0; i != row_->size(); ++i)
+    {
+        switch (row_->get_properties(i).get_data_type())
         {
         case dt_string:
-            bind_into<dt_string>();
-            break;
         case dt_blob:
-            bind_into<dt_string>();
-            break;
         case dt_xml:
-            bind_into<dt_string>();
+            bind_into<dt_string>(i);
             break;
         case dt_double:
-            bind_into<dt_double>();
+            bind_into<dt_double>(i);
             break;
         case dt_integer:
-            bind_into<dt_integer>();
+            bind_into<dt_integer>(i);
             break;
         case dt_long_long:
-            bind_into<dt_long_long>();
+            bind_into<dt_long_long>(i);
             break;
         case dt_unsigned_long_long:
-            bind_into<dt_unsigned_long_long>();
+            bind_into<dt_unsigned_long_long>(i);
             break;
         case dt_date:
-            bind_into<dt_date>();
+            bind_into<dt_date>(i);
             break;
-        default:
-            std::ostringstream msg;
-            msg << "db column type " << dtype
-                <<" not supported for dynamic selects"<<std::endl;
-            throw soci_error(msg.str());
         }
-        row_->add_properties(props);
     }
 
     alreadyDescribed_ = true;
@@ -825,3 +1110,106 @@ statement_impl::rethrow_current_exception_with_context(char const* operation)
         throw;
     }
 }
+
+async_result::async_result(statement_impl & st)
+    : impl_(&st), done_(false), gotData_(false)
+{
+    impl_->inc_ref();
+}
+
+async_result::async_result(statement_impl & st, bool gotData,
+                           std::exception_ptr error)
+    : impl_(&st), done_(true), gotData_(gotData), error_(error)
+{
+    impl_->inc_ref();
+}
+
+async_result::async_result(async_result && other) noexcept
+    : impl_(other.impl_), done_(other.done_), gotData_(other.gotData_),
+      error_(other.error_)
+{
+    // The moved from object must not do anything in its destructor.
+    other.impl_ = NULL;
+}
+
+async_result::~async_result()
+{
+    if (impl_ == NULL)
+        return;
+
+    if (!done_)
+    {
+        // There is no way to report the errors from here, so just ignore
+        // them: they're not interesting anyhow, as the execution is being
+        // cancelled. But do complete it even if waiting for it failed, to
+        // allow using the statement again.
+        try
+        {
+            impl_->cancel_async_execute();
+            impl_->poll_async_execute(true);
+        }
+        catch (...)
+        {
+        }
+
+        try
+        {
+            complete();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    impl_->dec_ref();
+}
+
+bool async_result::is_ready()
+{
+    if (!done_)
+    {
+        if (!impl_->poll_async_execute(false))
+            return false;
+
+        complete();
+    }
+
+    return true;
+}
+
+bool async_result::get()
+{
+    if (!done_)
+    {
+        impl_->poll_async_execute(true);
+
+        complete();
+    }
+
+    if (error_)
+        std::rethrow_exception(error_);
+
+    return gotData_;
+}
+
+void async_result::cancel()
+{
+    if (!done_)
+        impl_->cancel_async_execute();
+}
+
+void async_result::complete()
+{
+    done_ = true;
+
+    try
+    {
+        gotData_ = impl_->complete_async_execute();
+    }
+    catch (...)
+    {
+        // Remember the error to rethrow it from get() if it's called again.
+        error_ = std::current_exception();
+        throw;
+    }
+}
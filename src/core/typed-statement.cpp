@@ -0,0 +1,85 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/typed-statement.h"
+#include "soci/error.h"
+
+#include <sstream>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+// Check if the value of the column of the given type can be stored in a
+// variable of the given type.
+//
+// This is deliberately lax, as the column types reported by some backends,
+// notably SQLite, are not reliable, and only rejects the combinations which
+// can't work with any backend.
+bool is_compatible(exchange_type x, data_type type)
+{
+    switch (x)
+    {
+        case x_short:
+        case x_integer:
+        case x_long_long:
+        case x_unsigned_long_long:
+        case x_double:
+            return type != dt_date && type != dt_blob && type != dt_xml;
+
+        case x_stdtm:
+            return type == dt_date || type == dt_string;
+
+        case x_char:
+        case x_stdstring:
+        case x_xmltype:
+        case x_longstring:
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            break;
+    }
+
+    return true;
+}
+
+} // namespace anonymous
+
+void soci::details::check_typed_columns(statement_backend & backEnd,
+    int const * types, std::size_t count)
+{
+    int const numcols = backEnd.prepare_for_describe();
+    if (numcols != static_cast<int>(count))
+    {
+        std::ostringstream oss;
+        oss << "Typed statement expects " << count << " columns, but the query"
+               " returns " << numcols << ".";
+        throw soci_error(oss.str());
+    }
+
+    for (int i = 0; i != numcols; ++i)
+    {
+        if (types[i] == -1)
+        {
+            continue;
+        }
+
+        data_type type;
+        std::string name;
+        backEnd.describe_column(i + 1, type, name);
+
+        if (!is_compatible(static_cast<exchange_type>(types[i]), type))
+        {
+            std::ostringstream oss;
+            oss << "Type of the column " << i + 1 << " (\"" << name << "\") "
+                   "is incompatible with the typed statement element.";
+            throw soci_error(oss.str());
+        }
+    }
+}
@@ -45,6 +45,7 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <tuple>
 #include <typeinfo>
 #include <type_traits>
 
@@ -2483,6 +2484,24 @@ TEST_CASE_METHOD(common_tests, "Dynamic row binding", "[core][dynamic]")
             CHECK(t.tm_sec == 17);
             CHECK_EQUAL_PADDED(c, "a");
         }
+
+        // accessing the values without copying them
+        {
+            std::string const& s = r.get_ref<std::string>(2);
+            CHECK(s == "Johny");
+            CHECK(&r.get_ref<std::string>("NAME") == &s);
+            CHECK(r.get_ref<std::tm>(3).tm_mday == 19);
+            CHECK(r.get_ref<int>(1) == 123);
+            CHECK_THROWS_AS(r.get_ref<std::string>(0), std::bad_cast);
+
+#ifdef SOCI_HAVE_CXX17
+            CHECK(r.get_string_view("NAME") == "Johny");
+#endif // SOCI_HAVE_CXX17
+
+            std::string const moved = r.move_as<std::string>(2);
+            CHECK(moved == "Johny");
+            CHECK(r.move_as<int>("NUM_INT") == 123);
+        }
     }
 
     // additional test to check if the row object can be
@@ -2592,6 +2611,160 @@ TEST_CASE_METHOD(common_tests, "Dynamic row binding 3", "[core][dynamic]")
         CHECK(r2.get<std::string>("PHONE") == "(404)123-4567");
     }
     CHECK(count == 3);
+
+    // Column handles can be reused for all rows fetched by the statement.
+    st.execute();
+
+    column_handle const phone = r2.get_column_handle("PHONE");
+    CHECK(phone.get_position() == 1);
+    CHECK_THROWS_AS(r2.get_column_handle("NO_SUCH_COLUMN"), soci_error);
+
+    count = 0;
+    while (st.fetch())
+    {
+        ++count;
+        CHECK(r2.get_indicator(phone) == i_ok);
+        CHECK(r2.get<std::string>(phone) == "(404)123-4567");
+        CHECK(r2.get_ref<std::string>(phone) == "(404)123-4567");
+        CHECK(r2.get_properties(phone).get_name() == "PHONE");
+    }
+    CHECK(count == 3);
+
+    // But not with a row describing a different query.
+    row r3;
+    sql << "select * from soci_test", into(r3);
+    CHECK_THROWS_AS(r3.get<std::string>(phone), soci_error);
+    CHECK_THROWS_AS(r3.get<std::string>(column_handle()), soci_error);
+}
+
+struct TypedPerson
+{
+    int id;
+    std::string name;
+    double weight;
+};
+
+TEST_CASE_METHOD(common_tests, "Typed statement", "[core][typed]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    sql << "insert into soci_test(id, str, d) values(1, 'john', 72.5)";
+    sql << "insert into soci_test(id, str, d) values(2, 'jane', 58.25)";
+    sql << "insert into soci_test(id, str, d) values(3, 'joe', 80)";
+
+    typed_statement<std::tuple<int, std::string, double>, std::tuple<int> >
+        st(sql, "select id, str, d from soci_test where id >= :id order by id");
+
+    // The indicators are valid even before executing the statement.
+    CHECK(st.get_indicator(0) == i_null);
+
+    REQUIRE(st.execute(2));
+    CHECK(st.get<0>() == 2);
+    CHECK(st.get<1>() == "jane");
+    CHECK(st.get_indicator(1) == i_ok);
+    CHECK_THROWS_AS(st.get_indicator(3), std::out_of_range);
+
+    TypedPerson const p = st.get_as<TypedPerson>();
+    CHECK(p.id == 2);
+    CHECK(p.name == "jane");
+    ASSERT_EQUAL_APPROX(p.weight, 58.25);
+
+    REQUIRE(st.fetch());
+    CHECK(std::get<1>(st.get_row()) == "joe");
+    CHECK_FALSE(st.fetch());
+
+    // The same statement can be executed again with other parameters.
+    int count = 0;
+    for (bool ok = st.execute(1); ok; ok = st.fetch())
+    {
+        ++count;
+        CHECK(st.get<0>() == count);
+    }
+    CHECK(count == 3);
+
+    CHECK_FALSE(st.execute(4));
+
+    // The number of columns must match, this is checked on execution.
+    typedef typed_statement<std::tuple<int, std::string> > two_columns;
+    two_columns bad(sql, "select id from soci_test");
+    CHECK_THROWS_AS(bad.execute(), soci_error);
+
+    // The query is only executed by execute(), so the changes done after
+    // creating the statement must be taken into account.
+    typed_statement<std::tuple<int> > countStmt(sql,
+        "select count(*) from soci_test");
+    sql << "insert into soci_test(id, str, d) values(4, 'jim', 90)";
+    REQUIRE(countStmt.execute());
+    CHECK(countStmt.get<0>() == 4);
+}
+
+TEST_CASE_METHOD(common_tests, "Asynchronous execution", "[core][async]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    // The values of the use elements are taken when starting the execution.
+    int id = 1;
+    std::string str = "one";
+    statement ins = (sql.prepare <<
+        "insert into soci_test(id, str) values(:id, :str)", use(id), use(str));
+    {
+        async_result res = ins.execute_async(true);
+        id = 2;
+        str = "two";
+        CHECK_FALSE(res.get());
+    }
+    CHECK_FALSE(ins.execute_async(true).get());
+
+    // The into elements are filled when the execution completes.
+    std::string s;
+    int const wanted = 2;
+    statement sel = (sql.prepare << "select str from soci_test where id = :id",
+                     use(wanted), into(s));
+    {
+        async_result res = sel.execute_async(true);
+        CHECK(res.get());
+        CHECK(s == "two");
+
+        // The result can be retrieved more than once.
+        CHECK(res.get());
+        CHECK(res.is_ready());
+    }
+
+    // The rows not retrieved by the execution can be fetched later.
+    int n = 0;
+    statement all = (sql.prepare << "select id from soci_test order by id",
+                     into(n));
+    {
+        async_result res = all.execute_async(true);
+        REQUIRE(res.get());
+        CHECK(n == 1);
+    }
+    REQUIRE(all.fetch());
+    CHECK(n == 2);
+    CHECK_FALSE(all.fetch());
+
+    // The result keeps the statement alive.
+    int count = 0;
+    async_result resCount = [&]()
+    {
+        statement st = (sql.prepare << "select count(*) from soci_test",
+                        into(count));
+        return st.execute_async(true);
+    }();
+    CHECK(resCount.get());
+    CHECK(count == 2);
+
+    // Errors are reported when the result is retrieved.
+    double d = 0;
+    statement nul = (sql.prepare << "select d from soci_test where id = 1",
+                     into(d));
+    async_result resNull = nul.execute_async(true);
+    CHECK_THROWS_AS(resNull.get(), soci_error);
+    CHECK_THROWS_AS(resNull.get(), soci_error);
 }
 
 // This is like the previous test but with a type_conversion instead of a row
@@ -5529,6 +5702,25 @@ TEST_CASE_METHOD(common_tests, "CLOB vector", "[core][clob][vector]")
     REQUIRE(s2.size() == 2);
     CHECK(s2[0].value == s1[0].value);
     CHECK(s2[1].value == s1[1].value);
+
+    // Long values can also be fetched together with other columns, which
+    // may come either before or after them.
+    std::vector<int> ids2(2);
+    sql << "select id, s from soci_test order by id", into(ids2), into(s2);
+
+    REQUIRE(s2.size() == 2);
+    CHECK(ids2[1] == 2);
+    CHECK(s2[0].value == s1[0].value);
+    CHECK(s2[1].value == s1[1].value);
+
+    ids2.resize(2);
+    s2.resize(2);
+    sql << "select s, id from soci_test order by id", into(s2), into(ids2);
+
+    REQUIRE(s2.size() == 2);
+    CHECK(ids2[1] == 2);
+    CHECK(s2[0].value == s1[0].value);
+    CHECK(s2[1].value == s1[1].value);
 }
 
 TEST_CASE_METHOD(common_tests, "XML", "[core][xml]")
@@ -14,12 +14,52 @@
 #include <catch.hpp>
 
 #include <iostream>
+#include <memory>
+#include <new>
 #include <string>
 #include <cstdlib>
 #include <ctime>
 
 using namespace soci;
 
+// Count all heap allocations to be able to show how many of them are done by
+// SOCI itself, as the empty backend doesn't allocate anything on its own
+// except for its statement and into/use objects.
+static std::size_t allocationsCount = 0;
+
+// The same counters, but per thread, used for SOCI exchange statistics.
+static thread_local std::size_t threadAllocations = 0;
+static thread_local std::size_t threadBytesAllocated = 0;
+
+static void get_thread_allocations(std::size_t& allocations, std::size_t& bytes)
+{
+    allocations = threadAllocations;
+    bytes = threadBytesAllocated;
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocationsCount;
+    ++threadAllocations;
+    threadBytesAllocated += size;
+
+    void* const p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
 std::string connectString;
 backend_factory const &backEnd = *soci::factory_empty();
 
@@ -141,6 +181,344 @@ TEST_CASE("Dummy test", "[empty]")
     }
 }
 
+TEST_CASE("Synthetic data", "[empty][synthetic]")
+{
+    soci::session sql(backEnd,
+        "rows=5 columns=int,string,double string_length=3 null_ratio=0.5");
+
+    SECTION("Single row")
+    {
+        int i = 0;
+        std::string s;
+        indicator ind = i_ok;
+        sql << "select", into(i), into(s, ind);
+        CHECK(sql.got_data());
+        CHECK(i == 1);
+        CHECK(ind == i_null);
+
+        soci::session sqlNoNulls(backEnd, "rows=3 string_length=3");
+        statement st = (sqlNoNulls.prepare << "select", into(i), into(s));
+        st.execute();
+
+        int count = 0;
+        while (st.fetch())
+        {
+            ++count;
+            CHECK(i == count);
+            CHECK(s == "abc");
+        }
+        CHECK(count == 3);
+    }
+
+    SECTION("Null without indicator")
+    {
+        int i = 0;
+        std::string s;
+        CHECK_THROWS_AS((sql << "select", into(i), into(s)), soci_error);
+    }
+
+    SECTION("Vectors")
+    {
+        std::vector<long long> v(3);
+        std::vector<indicator> inds(3);
+        statement st = (sql.prepare << "select", into(v, inds));
+        st.execute();
+
+        CHECK(st.fetch());
+        REQUIRE(v.size() == 3);
+        CHECK(inds[0] == i_ok);
+        CHECK(v[0] == 1);
+        CHECK(inds[1] == i_null);
+        CHECK(inds[2] == i_ok);
+        CHECK(v[2] == 3);
+
+        CHECK(st.fetch());
+        REQUIRE(v.size() == 2);
+        CHECK(inds[0] == i_null);
+        CHECK(v[1] == 5);
+
+        CHECK(!st.fetch());
+    }
+
+    SECTION("Bulk use")
+    {
+        std::vector<int> ids(10);
+        statement st = (sql.prepare << "insert", use(ids));
+        st.execute(true);
+        CHECK(st.get_affected_rows() == 10);
+    }
+
+    SECTION("Dynamic rows")
+    {
+        rowset<row> rs = (sql.prepare << "select");
+
+        int count = 0;
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            row const& r = *it;
+            REQUIRE(r.size() == 3);
+            CHECK(r.get_properties(1).get_name() == "col2");
+            CHECK(r.get_properties(2).get_data_type() == dt_double);
+            CHECK(r.get<int>(0, -1) == (count % 2 ? -1 : count + 1));
+            ++count;
+        }
+        CHECK(count == 5);
+    }
+
+    SECTION("Invalid options")
+    {
+        CHECK_THROWS_AS(soci::session(backEnd, "rows=-1"), soci_error);
+        CHECK_THROWS_AS(soci::session(backEnd, "columns=foo"), soci_error);
+        CHECK_THROWS_AS(soci::session(backEnd, "null_ratio=2"), soci_error);
+        CHECK_THROWS_AS(soci::session(backEnd, "bloops=1"), soci_error);
+    }
+}
+
+TEST_CASE("Exchange arena", "[empty][arena]")
+{
+    int i = 0;
+    details::exchange_arena arena;
+
+    std::vector<details::into_type_base*> intos;
+    {
+        details::exchange_arena_scope scope(&arena);
+        for (int n = 0; n < 3; ++n)
+            intos.push_back(new details::into_type<int>(i));
+    }
+
+    CHECK(arena.get_objects_count() == 3);
+    CHECK(arena.get_heap_chunks_count() == 0);
+
+    // Elements created outside of the scope don't use the arena.
+    details::into_type_base* const heapInto = new details::into_type<int>(i);
+    CHECK(arena.get_objects_count() == 3);
+    delete heapInto;
+
+    {
+        details::exchange_arena_scope scope(&arena);
+        for (int n = 0; n < 100; ++n)
+            intos.push_back(new details::into_type<int>(i));
+    }
+
+    CHECK(arena.get_objects_count() == 103);
+
+    std::size_t const chunks = arena.get_heap_chunks_count();
+    CHECK(chunks > 0);
+
+    for (std::size_t n = 0; n != intos.size(); ++n)
+        delete intos[n];
+    intos.clear();
+
+    CHECK(arena.get_objects_count() == 0);
+
+    // The memory is reused once all elements are destroyed.
+    {
+        details::exchange_arena_scope scope(&arena);
+        for (int n = 0; n < 103; ++n)
+            intos.push_back(new details::into_type<int>(i));
+    }
+
+    CHECK(arena.get_heap_chunks_count() == chunks);
+
+    for (std::size_t n = 0; n != intos.size(); ++n)
+        delete intos[n];
+}
+
+// Into element not using any backend element and counting the calls to its
+// hooks.
+class counting_into : public details::into_type_base
+{
+public:
+    counting_into(int & preExecCalls, int & preFetchCalls)
+        : preExecCalls_(preExecCalls), preFetchCalls_(preFetchCalls) {}
+
+private:
+    void define(details::statement_impl &, int &) override {}
+    void pre_exec(int) override { ++preExecCalls_; }
+    void pre_fetch() override { ++preFetchCalls_; }
+    void post_fetch(bool, bool) override {}
+    void clean_up() override {}
+    std::size_t size() const override { return 1; }
+
+    int & preExecCalls_;
+    int & preFetchCalls_;
+};
+
+TEST_CASE("Exchange hooks", "[empty][hooks]")
+{
+    soci::session sql(backEnd, connectString);
+
+    // The empty backend doesn't need the optional hooks, but the elements
+    // not using the backend must still have them called.
+    int i = 0;
+    int preExecCalls = 0;
+    int preFetchCalls = 0;
+    statement st(sql);
+    st.exchange(into(i));
+    st.exchange(details::into_type_ptr(
+        new counting_into(preExecCalls, preFetchCalls)));
+    st.alloc();
+    st.prepare("select");
+    st.define_and_bind();
+
+    st.execute(true);
+    CHECK(preExecCalls == 1);
+    CHECK(preFetchCalls == 1);
+}
+
+// Type allocating its value on the heap when it's fetched.
+struct boxed_int
+{
+    std::unique_ptr<int> value;
+};
+
+namespace soci
+{
+    template<> struct type_conversion<boxed_int>
+    {
+        typedef int base_type;
+        static void from_base(int i, indicator /* ind */, boxed_int & b)
+        {
+            b.value.reset(new int(i));
+        }
+    };
+}
+
+TEST_CASE("Exchange statistics", "[empty][stats]")
+{
+    soci::session sql(backEnd, "rows=3 columns=int,string string_length=10");
+
+    int i = 0;
+    std::string s;
+    int const id = 17;
+    statement st = (sql.prepare << "select", into(i), into(s), use(id));
+
+    st.execute();
+
+#ifdef SOCI_HAVE_INSTRUMENTATION
+    // Executing without data exchange only calls pre_use() and post_use() of
+    // the use element, as pre_exec() is skipped for the backends not needing
+    // it.
+    CHECK(st.get_exchange_stats().executes == 1);
+    CHECK(st.get_exchange_stats().fetches == 0);
+    CHECK(st.get_exchange_stats().exchangeCalls == 2);
+
+    st.reset_exchange_stats();
+    REQUIRE(st.fetch());
+
+    exchange_stats const & stats = st.get_exchange_stats();
+    CHECK(stats.executes == 0);
+    CHECK(stats.fetches == 1);
+    CHECK(stats.exchangeCalls == 2);
+    CHECK(stats.bytesCopied == 10);
+
+    // Fetching into the same variables again shouldn't allocate anything,
+    // including in the standard containers, as all allocations are counted
+    // by this program, see main().
+    std::size_t const before = allocationsCount;
+    st.reset_exchange_stats();
+    REQUIRE(st.fetch());
+    CHECK(stats.allocations == 0);
+    CHECK(stats.bytesAllocated == 0);
+    CHECK(allocationsCount == before);
+
+    // But the allocations done by the type conversions are counted.
+    boxed_int b;
+    statement stBoxed = (sql.prepare << "select", into(b));
+    stBoxed.execute();
+    stBoxed.reset_exchange_stats();
+    REQUIRE(stBoxed.fetch());
+    CHECK(stBoxed.get_exchange_stats().allocations == 1);
+    CHECK(stBoxed.get_exchange_stats().bytesAllocated == sizeof(int));
+
+    CHECK(i == 2);
+#else // !SOCI_HAVE_INSTRUMENTATION
+    REQUIRE(st.fetch());
+
+    // Nothing is counted without instrumentation.
+    CHECK(st.get_exchange_stats().executes == 0);
+    CHECK(st.get_exchange_stats().exchangeCalls == 0);
+
+    CHECK(i == 1);
+#endif // SOCI_HAVE_INSTRUMENTATION
+
+    CHECK(s == "abcdefghij");
+}
+
+TEST_CASE("Typed statement", "[empty][typed]")
+{
+    soci::session sql(backEnd, "rows=3 columns=int,string string_length=2");
+
+    typed_statement<std::tuple<int, std::string> > st(sql, "select");
+
+    int count = 0;
+    for (bool ok = st.execute(); ok; ok = st.fetch())
+    {
+        ++count;
+        CHECK(st.get<0>() == count);
+        CHECK(st.get<1>() == "ab");
+    }
+    CHECK(count == 3);
+
+    // Column types are checked when the statement is executed.
+    typed_statement<std::tuple<std::tm, std::string> > bad(sql, "select");
+    CHECK_THROWS_AS(bad.execute(), soci_error);
+    CHECK_THROWS_AS(bad.execute(), soci_error);
+}
+
+// This test is not run by default, use "[benchmark]" to run it explicitly.
+TEST_CASE("Allocations per query", "[.][benchmark][empty]")
+{
+    soci::session sql(backEnd, connectString);
+
+    int i1 = 0, i2 = 0, i3 = 0;
+    int const u1 = 1, u2 = 2, u3 = 3;
+
+    int const iterations = 1000;
+
+    std::size_t const before = allocationsCount;
+    for (int n = 0; n < iterations; ++n)
+    {
+        sql << "select", into(i1), into(i2), into(i3),
+                         use(u1), use(u2), use(u3);
+    }
+
+    std::cout << "Allocations per query with 3 into and 3 use elements: "
+              << static_cast<double>(allocationsCount - before) / iterations
+              << "\n";
+}
+
+TEST_CASE("Values stored without row", "[empty][values]")
+{
+    values v;
+    v.set("id", 17);
+    v.set("name", std::string("John"));
+
+    CHECK(v.get<int>("id") == 17);
+    CHECK(v.get<std::string>("name") == "John");
+    CHECK(v.get_indicator("name") == i_ok);
+
+    // Updating an existing value reuses its storage.
+    v.set("id", 42);
+    CHECK(v.get<int>("id") == 42);
+
+    CHECK_THROWS_AS(v.get<std::string>("id"), soci_error);
+    CHECK_THROWS_AS(v.set("name", 3), std::bad_cast);
+
+    // Copies of holder values are independent of each other.
+    details::value_holder h(std::string("abc"));
+    details::value_holder h2(h);
+    h.get<std::string>() += "def";
+    CHECK(h2.get<std::string>() == "abc");
+    CHECK(h2.get_type() == dt_string);
+    CHECK_THROWS_AS(h2.get<int>(), std::bad_cast);
+    CHECK_THROWS_AS(h2.get<short>(), std::bad_cast);
+
+    details::value_holder const blob(dt_blob);
+    CHECK(blob.holds<std::string>());
+    CHECK(blob.get<std::string>().empty());
+}
+
 
 int main(int argc, char** argv)
 {
@@ -154,6 +532,10 @@ int main(int argc, char** argv)
     _CrtSetReportFile(_CRT_ERROR, _CRTDBG_FILE_STDERR);
 #endif //_MSC_VER
 
+    // Count all allocations in the exchange statistics, not only those done
+    // by SOCI itself.
+    details::set_allocation_hook(get_thread_allocations);
+
     if (argc >= 2)
     {
         connectString = argv[1];
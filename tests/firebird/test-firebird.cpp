@@ -500,6 +500,78 @@ TEST_CASE("Firebird bulk operations", "[firebird][bulk]")
     sql << "drop table test6";
 }
 
+TEST_CASE("Firebird bulk insert in batch", "[firebird][bulk]")
+{
+    soci::session sql(backEnd, connectString);
+
+    try
+    {
+        sql << "drop table test_batch";
+    }
+    catch (soci_error const &)
+    {} // ignore if error
+
+    sql << "create table test_batch (id integer primary key, "
+           "name varchar(20), val double precision)";
+    sql.commit();
+
+    sql.begin();
+
+    int const rows = 10000;
+    std::vector<int> ids(rows);
+    std::vector<std::string> names(rows);
+    std::vector<indicator> inds(rows);
+    std::vector<double> vals(rows);
+    for (int i = 0; i != rows; ++i)
+    {
+        ids[i] = i;
+
+        std::ostringstream ss;
+        ss << "name_" << i;
+        names[i] = ss.str();
+        inds[i] = i % 10 ? i_ok : i_null;
+
+        vals[i] = i / 4.0;
+    }
+
+    statement st = (sql.prepare <<
+        "insert into test_batch(id, name, val) values(:id, :name, :val)",
+        use(ids), use(names, inds), use(vals));
+    st.execute(true);
+    CHECK(st.get_affected_rows() == rows);
+
+    int count = 0;
+    sql << "select count(*) from test_batch", into(count);
+    CHECK(count == rows);
+
+    sql << "select count(*) from test_batch where name is null", into(count);
+    CHECK(count == rows / 10);
+
+    std::string name;
+    double val = 0;
+    sql << "select name, val from test_batch where id = 1234",
+        into(name), into(val);
+    CHECK(name == "name_1234");
+    CHECK(val == 308.5);
+
+    // Check that the rows before the failing one are still inserted and
+    // counted as affected.
+    std::vector<int> ids2;
+    ids2.push_back(rows);
+    ids2.push_back(rows + 1);
+    ids2.push_back(0); // duplicate
+    ids2.push_back(rows + 2);
+
+    statement st2 = (sql.prepare <<
+        "insert into test_batch(id) values(:id)", use(ids2));
+    CHECK_THROWS_AS(st2.execute(true), firebird_soci_error);
+    CHECK(st2.get_affected_rows() == 2);
+
+    sql.rollback();
+
+    sql << "drop table test_batch";
+}
+
 // blob test
 TEST_CASE("Firebird blobs", "[firebird][blob]")
 {
@@ -633,6 +705,58 @@ TEST_CASE("Firebird blobs", "[firebird][blob]")
         CHECK(data == data2);
     }
 
+    {
+        // write and read a blob in chunks, which are streamed to and from
+        // the database without loading the entire blob in memory
+        const std::size_t chunkSize = 100000;
+        const int chunks = 30;
+
+        std::vector<char> chunk(chunkSize);
+        blob b(sql);
+        for (int n = 0; n != chunks; ++n)
+        {
+            for (std::size_t i = 0; i != chunkSize; ++i)
+                chunk[i] = static_cast<char>('a' + (n + i) % 26);
+
+            b.append(&chunk[0], chunkSize);
+        }
+        CHECK(b.get_len() == chunkSize * chunks);
+        sql << "insert into test7(id, img) values(4,?)", use(b);
+
+        blob br(sql);
+        sql << "select img from test7 where id = 4", into(br);
+        CHECK(br.get_len() == chunkSize * chunks);
+
+        std::size_t offset = 0;
+        for (int n = 0; n != chunks; ++n)
+        {
+            CHECK(br.read_from_start(&chunk[0], chunkSize, offset) == chunkSize);
+            CHECK(chunk[0] == static_cast<char>('a' + n % 26));
+            CHECK(chunk[chunkSize - 1] ==
+                  static_cast<char>('a' + (n + chunkSize - 1) % 26));
+            offset += chunkSize;
+        }
+
+        // reading past the end returns nothing
+        CHECK(br.read_from_start(&chunk[0], chunkSize, offset) == 0);
+
+        // reading backwards is still possible
+        char c = 0;
+        CHECK(br.read_from_start(&c, 1, chunkSize + 1) == 1);
+        CHECK(c == 'a' + 2);
+    }
+
+    {
+        // a blob which was written to but never saved can be destroyed even
+        // after the end of the transaction in which it was created
+        std::vector<char> chunk(1000, 'x');
+        blob b(sql);
+        b.append(&chunk[0], chunk.size());
+
+        sql.rollback();
+        sql.begin();
+    }
+
     sql << "drop table test7";
 }
 
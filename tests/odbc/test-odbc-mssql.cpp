@@ -12,6 +12,7 @@
 #include <string>
 #include <ctime>
 #include <cmath>
+#include <thread>
 
 using namespace soci;
 using namespace soci::tests;
@@ -75,6 +76,145 @@ TEST_CASE("MS SQL long string", "[odbc][mssql][long]")
     );
 }
 
+TEST_CASE("MS SQL row-wise binding", "[odbc][mssql][vector]")
+{
+    connection_parameters parameters(backEnd, connectString);
+    parameters.set_option(odbc_option_row_wise_binding, "1");
+    soci::session sql(parameters);
+
+    struct wide_table_creator : public table_creator_base
+    {
+        explicit wide_table_creator(soci::session& sql)
+            : table_creator_base(sql)
+        {
+            sql << "create table soci_test ("
+                        "id integer, "
+                        "sh smallint, "
+                        "d float, "
+                        "str varchar(20) null, "
+                        "tm datetime"
+                    ")";
+        }
+    } wide_table_creator(sql);
+
+    for (int i = 0; i != 10; ++i)
+    {
+        std::tm t = std::tm();
+        t.tm_year = 120;
+        t.tm_mon = 0;
+        t.tm_mday = i + 1;
+
+        short sh = static_cast<short>(i);
+        double d = i / 2.0;
+        std::string str(i, 'x');
+        indicator ind = i % 3 ? i_ok : i_null;
+        sql << "insert into soci_test(id, sh, d, str, tm) "
+               "values(:id, :sh, :d, :str, :tm)",
+            use(i), use(sh), use(d), use(str, ind), use(t);
+    }
+
+    std::vector<int> ids(4);
+    std::vector<short> shs(4);
+    std::vector<double> ds(4);
+    std::vector<std::string> strs(4);
+    std::vector<indicator> inds(4);
+    std::vector<std::tm> tms(4);
+
+    statement st = (sql.prepare <<
+        "select id, sh, d, str, tm from soci_test order by id",
+        into(ids), into(shs), into(ds), into(strs, inds), into(tms));
+    st.execute();
+
+    odbc_statement_backend* const stbe
+        = static_cast<odbc_statement_backend*>(st.get_backend());
+    CHECK(stbe->get_row_wise_binding());
+
+    int total = 0;
+    while (st.fetch())
+    {
+        // Switching between row-wise and column-wise binding between fetches
+        // must work too.
+        stbe->set_row_wise_binding(!stbe->get_row_wise_binding());
+
+        for (std::size_t n = 0; n != ids.size(); ++n, ++total)
+        {
+            CHECK(ids[n] == total);
+            CHECK(shs[n] == total);
+            CHECK(ds[n] == Approx(total / 2.0));
+            if (total % 3)
+            {
+                CHECK(inds[n] == i_ok);
+                CHECK(strs[n] == std::string(total, 'x'));
+            }
+            else
+            {
+                CHECK(inds[n] == i_null);
+            }
+            CHECK(tms[n].tm_mday == total + 1);
+        }
+    }
+
+    CHECK(total == 10);
+}
+
+TEST_CASE("MS SQL asynchronous execution", "[odbc][mssql][async]")
+{
+    // Use separate sessions to allow the statements to run concurrently.
+    soci::session sql1(backEnd, connectString);
+    soci::session sql2(backEnd, connectString);
+
+    int n1 = 0;
+    statement st1 = (sql1.prepare << "select count(*) from sys.objects",
+                     into(n1));
+    st1.define_and_bind();
+
+    int n2 = 0;
+    statement st2 = (sql2.prepare << "waitfor delay '00:00:00.1'; "
+                                     "select count(*) from sys.objects",
+                     into(n2));
+    st2.define_and_bind();
+
+    async_result res1 = st1.execute_async(true);
+    async_result res2 = st2.execute_async(true);
+
+    while (!res1.is_ready() || !res2.is_ready())
+        std::this_thread::yield();
+
+    CHECK(res1.get());
+    CHECK(res2.get());
+    CHECK(n1 > 0);
+    CHECK(n1 == n2);
+
+    // The statement can't be used while it's being executed.
+    {
+        async_result res = st2.execute_async(true);
+        if (!res.is_ready())
+        {
+            CHECK_THROWS_AS(st2.execute(true), soci_error);
+            CHECK_THROWS_AS(st2.fetch(), soci_error);
+        }
+    }
+
+    // The statement can be executed synchronously again after completion.
+    st1.execute(true);
+    CHECK(n1 == n2);
+
+    // The parameters are bound before starting the execution.
+    int const minId = 0;
+    int n3 = 0;
+    statement st3 = (sql1.prepare <<
+        "select count(*) from sys.objects where object_id > :id",
+        use(minId), into(n3));
+    CHECK(st3.execute_async(true).get());
+    CHECK(n3 == n1);
+
+    // Errors are reported when the result is retrieved.
+    statement st4 = (sql1.prepare << "select * from soci_no_such_table");
+    async_result res4 = st4.execute_async();
+    CHECK_THROWS_AS(res4.get(), odbc_soci_error);
+    CHECK_THROWS_AS(res4.get(), odbc_soci_error);
+}
+
 // DDL Creation objects for common tests
 struct table_creator_one : public table_creator_base
 {
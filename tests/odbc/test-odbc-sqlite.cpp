@@ -0,0 +1,144 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Tests of the ODBC-specific features which can be run using unixODBC and
+// SQLite ODBC driver, without any database server.
+
+#include "soci/soci.h"
+#include "soci/odbc/soci-odbc.h"
+
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace soci;
+
+std::string connectString;
+backend_factory const &backEnd = *soci::factory_odbc();
+
+namespace
+{
+
+struct table_creator
+{
+    explicit table_creator(soci::session& sql)
+        : sql_(sql)
+    {
+        drop();
+        sql_ << "create table soci_test(id integer primary key, str varchar(20))";
+    }
+
+    ~table_creator()
+    {
+        drop();
+    }
+
+private:
+    void drop()
+    {
+        try { sql_ << "drop table soci_test"; } catch (soci_error const&) {}
+    }
+
+    soci::session& sql_;
+};
+
+} // anonymous namespace
+
+TEST_CASE("ODBC asynchronous execution", "[odbc][async]")
+{
+    soci::session sql(backEnd, connectString);
+    table_creator tableCreator(sql);
+
+    // SQLite ODBC driver doesn't support asynchronous execution, so this
+    // tests the synchronous fallback, but the test works in either case.
+    int id = 0;
+    std::string str;
+    statement ins = (sql.prepare <<
+        "insert into soci_test(id, str) values(:id, :str)", use(id), use(str));
+    for (id = 1; id <= 3; ++id)
+    {
+        str = std::to_string(id);
+        async_result res = ins.execute_async(true);
+        while (!res.is_ready())
+            std::this_thread::yield();
+
+        CHECK_FALSE(res.get());
+    }
+
+    // The rows are exchanged by the execution itself and fetch() continues
+    // from the next one.
+    int const minId = 1;
+    std::vector<int> ids(2);
+    statement sel = (sql.prepare <<
+        "select id from soci_test where id >= :id order by id",
+        use(minId), into(ids));
+    {
+        async_result res = sel.execute_async(true);
+        REQUIRE(res.get());
+        REQUIRE(ids.size() == 2);
+        CHECK(ids[0] == 1);
+        CHECK(ids[1] == 2);
+    }
+
+    REQUIRE(sel.fetch());
+    REQUIRE(ids.size() == 1);
+    CHECK(ids[0] == 3);
+    CHECK_FALSE(sel.fetch());
+
+    // The statement can be executed synchronously again after completion.
+    ids.resize(2);
+    CHECK(sel.execute(true));
+    CHECK(ids[0] == 1);
+
+    // Destroying the result without waiting for it leaves the statement
+    // usable.
+    int count = 0;
+    statement cnt = (sql.prepare << "select count(*) from soci_test",
+                     into(count));
+    cnt.execute_async(true);
+    CHECK(cnt.execute(true));
+    CHECK(count == 3);
+
+    // Errors are reported when the result is retrieved.
+    id = 1;
+    str = "duplicate";
+    async_result resDup = ins.execute_async(true);
+    CHECK_THROWS_AS(resDup.get(), odbc_soci_error);
+    CHECK_THROWS_AS(resDup.get(), odbc_soci_error);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef _MSC_VER
+    // Redirect errors, unrecoverable problems, and assert() failures to STDERR,
+    // instead of debug message window.
+    // This hack is required to run assert()-driven tests by Buildbot.
+    // NOTE: Comment this 2 lines for debugging with Visual C++ debugger to catch assertions inside.
+    _CrtSetReportMode(_CRT_ERROR, _CRTDBG_MODE_FILE);
+    _CrtSetReportFile(_CRT_ERROR, _CRTDBG_FILE_STDERR);
+#endif //_MSC_VER
+
+    if (argc >= 2 && argv[1][0] != '-')
+    {
+        connectString = argv[1];
+
+        // Replace the connect string with the process name to ensure that
+        // CATCH uses the correct name in its messages.
+        argv[1] = argv[0];
+
+        argc--;
+        argv++;
+    }
+    else
+    {
+        connectString = "FILEDSN=./test-sqlite.dsn";
+    }
+
+    return Catch::Session().run(argc, argv);
+}
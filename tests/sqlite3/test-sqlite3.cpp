@@ -12,9 +12,17 @@
 #include <sstream>
 #include <string>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace soci;
 using namespace soci::tests;
 
@@ -319,6 +327,71 @@ struct test3_table_creator : table_creator_base
     }
 };
 
+TEST_CASE("SQLite blob incremental I/O", "[sqlite][blob]")
+{
+    soci::session sql(backEnd, connectString);
+
+    blob_table_creator tableCreator(sql);
+
+    sql << "insert into soci_test(id, img) values(7, zeroblob(10))";
+    sql << "insert into soci_test(id, img) values(8, zeroblob(3))";
+
+    long long rid7 = 0, rid8 = 0;
+    sql << "select rowid from soci_test where id = 7", into(rid7);
+    sql << "select rowid from soci_test where id = 8", into(rid8);
+
+    {
+        blob b(sql);
+        sqlite3_blob_backend* const bbe =
+            static_cast<sqlite3_blob_backend*>(b.get_backend());
+
+        bbe->open("soci_test", "img", rid7);
+        CHECK(bbe->is_open());
+        CHECK(b.get_len() == 10);
+
+        b.write_from_start("abcde", 5);
+        b.write_from_start("xyz", 3, 7);
+
+        char buf[10];
+        CHECK(b.read_from_start(buf, 4, 6) == 4);
+        CHECK(std::memcmp(buf, "\0xyz", 4) == 0);
+
+        // Reading past the end only reads what is available.
+        CHECK(b.read_from_start(buf, sizeof(buf), 8) == 2);
+        CHECK(b.read_from_start(buf, sizeof(buf), 10) == 0);
+
+        // The size of the BLOB can't change.
+        CHECK_THROWS_AS(b.write_from_start("0123", 4, 8), soci_error);
+        CHECK_THROWS_AS(b.append("0", 1), soci_error);
+        CHECK_THROWS_AS(b.trim(1), soci_error);
+
+        bbe->reopen(rid8);
+        CHECK(b.get_len() == 3);
+        b.write_from_start("123", 3);
+
+        bbe->close();
+        CHECK(!bbe->is_open());
+    }
+
+    std::string s;
+    sql << "select cast(substr(img, 1, 5) as text) from soci_test where id = 7", into(s);
+    CHECK(s == "abcde");
+    sql << "select cast(img as text) from soci_test where id = 8", into(s);
+    CHECK(s == "123");
+
+    {
+        blob b(sql);
+        sqlite3_blob_backend* const bbe =
+            static_cast<sqlite3_blob_backend*>(b.get_backend());
+
+        bbe->open("soci_test", "img", rid7, true);
+        CHECK_THROWS_AS(b.write_from_start("0", 1), soci_error);
+        CHECK_THROWS_AS(bbe->open("soci_test", "no_such_column", rid7),
+                        sqlite3_soci_error);
+        CHECK(!bbe->is_open());
+    }
+}
+
 TEST_CASE("SQLite use and vector into", "[sqlite][use][into][vector]")
 {
     soci::session sql(backEnd, connectString);
@@ -768,6 +841,612 @@ TEST_CASE("SQLite std::tm bind", "[sqlite][std-tm-bind]")
     CHECK(std::mktime(&result.front()) == std::mktime(&datetime));
 }
 
+struct table_creator_for_vector_into_strings : table_creator_base
+{
+    table_creator_for_vector_into_strings(soci::session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(val integer, str text)";
+    }
+};
+
+TEST_CASE("SQLite vector into strings fetched in batches", "[sqlite][vector][into]")
+{
+    soci::session sql(backEnd, connectString);
+    table_creator_for_vector_into_strings tableCreator(sql);
+
+    // Use strings of different sizes to exercise reusing the row cache
+    // storage from the previous fetch as well as growing it.
+    const int count = 100;
+    for (int i = 0; i != count; ++i)
+    {
+        std::string const s(i * 37, static_cast<char>('a' + i % 26));
+        sql << "insert into soci_test(val, str) values(:val, :str)",
+            use(i), use(s);
+    }
+
+    std::vector<int> vals(7);
+    std::vector<std::string> strs(7);
+    std::vector<indicator> inds(7);
+    statement st = (sql.prepare <<
+        "select val, str from soci_test order by val",
+        into(vals), into(strs, inds));
+    st.execute();
+
+    int n = 0;
+    while (st.fetch())
+    {
+        REQUIRE(vals.size() == strs.size());
+        for (std::size_t i = 0; i != vals.size(); ++i, ++n)
+        {
+            CHECK(vals[i] == n);
+            CHECK(inds[i] == i_ok);
+            CHECK(strs[i] == std::string(n * 37, static_cast<char>('a' + n % 26)));
+        }
+    }
+
+    CHECK(n == count);
+}
+
+TEST_CASE("SQLite vector into with nulls and conversions", "[sqlite][vector][into]")
+{
+    soci::session sql(backEnd, connectString);
+    table_creator_for_vector_into_strings tableCreator(sql);
+
+    sql << "insert into soci_test(val, str) values(1, 'one')";
+    sql << "insert into soci_test(val, str) values(NULL, NULL)";
+    sql << "insert into soci_test(val, str) values(3, '3')";
+
+    // The numbers are stored directly in the vectors while converting them to
+    // strings or the strings to numbers uses the row cache: check that both
+    // work in the same statement.
+    std::vector<long long> vals(3);
+    std::vector<std::string> valsAsStr(3);
+    std::vector<std::string> strs(3);
+    std::vector<indicator> valInds(3), valStrInds(3), strInds(3);
+    sql << "select val, val, str from soci_test order by rowid",
+        into(vals, valInds), into(valsAsStr, valStrInds), into(strs, strInds);
+
+    REQUIRE(vals.size() == 3);
+    CHECK(valInds[0] == i_ok);
+    CHECK(vals[0] == 1);
+    CHECK(valsAsStr[0] == "1");
+    CHECK(strs[0] == "one");
+    CHECK(valInds[1] == i_null);
+    CHECK(valStrInds[1] == i_null);
+    CHECK(strInds[1] == i_null);
+    CHECK(vals[2] == 3);
+    CHECK(valsAsStr[2] == "3");
+    CHECK(strs[2] == "3");
+
+    std::vector<int> noInds(3);
+    CHECK_THROWS_WITH((sql << "select val from soci_test order by rowid", into(noInds)),
+                      Catch::Contains("Null value fetched and no indicator defined"));
+}
+
+TEST_CASE("SQLite bulk insert from vectors", "[sqlite][vector][use]")
+{
+    soci::session sql(backEnd, connectString);
+    table_creator_for_vector_into_strings tableCreator(sql);
+
+    std::vector<int> vals;
+    std::vector<std::string> strs;
+    std::vector<indicator> inds;
+    for (int i = 0; i != 10; ++i)
+    {
+        vals.push_back(i);
+        strs.push_back(std::string(i, 'x'));
+        inds.push_back(i % 3 ? i_ok : i_null);
+    }
+
+    statement st = (sql.prepare <<
+        "insert into soci_test(val, str) values(:val, :str)",
+        use(vals), use(strs, inds));
+    st.execute(true);
+    CHECK(st.get_affected_rows() == 10);
+
+    // Modifying the vectors between executions is taken into account.
+    strs[1] = "one";
+    vals.resize(2);
+    strs.resize(2);
+    inds.resize(2);
+    st.execute(true);
+    CHECK(st.get_affected_rows() == 2);
+
+    int count = 0;
+    sql << "select count(*) from soci_test where str is null", into(count);
+    CHECK(count == 5);
+
+    std::string s;
+    sql << "select str from soci_test where val = 1 and rowid > 10", into(s);
+    CHECK(s == "one");
+
+    // Vectors of size 1 can be combined with scalar use elements.
+    std::vector<int> one(1, 42);
+    std::string const str("forty two");
+    sql << "insert into soci_test(val, str) values(:val, :str)",
+        use(one), use(str);
+    sql << "select str from soci_test where val = 42", into(s);
+    CHECK(s == "forty two");
+}
+
+struct table_creator_for_bulk_batches : table_creator_base
+{
+    table_creator_for_bulk_batches(soci::session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(val integer unique)";
+    }
+};
+
+TEST_CASE("SQLite bulk insert in batches", "[sqlite][vector][use]")
+{
+    soci::session sql(backEnd, "dbname=:memory: bulk_batch_size=3");
+    table_creator_for_bulk_batches tableCreator(sql);
+
+    std::vector<int> vals;
+    for (int i = 0; i != 10; ++i)
+    {
+        vals.push_back(i);
+    }
+
+    statement st = (sql.prepare <<
+        "insert into soci_test(val) values(:val)", use(vals));
+    st.execute(true);
+    CHECK(st.get_affected_rows() == 10);
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 10);
+
+    // The batches committed before the failure are kept while the changes
+    // done by the failing one are rolled back.
+    sql << "delete from soci_test";
+    vals[7] = 0;
+    CHECK_THROWS_AS(st.execute(true), soci_error);
+    CHECK(st.get_affected_rows() == 6);
+
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 6);
+
+    // Inside an explicit transaction the rows are not committed in batches.
+    sql << "delete from soci_test";
+    {
+        transaction tr(sql);
+        CHECK_THROWS_AS(st.execute(true), soci_error);
+        tr.rollback();
+    }
+
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 0);
+
+    // The batch size can be changed for a single statement.
+    sqlite3_statement_backend* const stbe
+        = static_cast<sqlite3_statement_backend*>(st.get_backend());
+    CHECK(stbe->get_bulk_batch_size() == 3);
+    stbe->set_bulk_batch_size(5);
+    CHECK_THROWS_AS(st.execute(true), soci_error);
+    CHECK(st.get_affected_rows() == 5);
+
+    CHECK_THROWS_AS(stbe->set_bulk_batch_size(-1), soci_error);
+    CHECK(stbe->get_bulk_batch_size() == 5);
+
+    // Invalid values of the parameter are rejected.
+    CHECK_THROWS_AS(soci::session(backEnd, "dbname=:memory: bulk_batch_size=-1"),
+                    soci_error);
+    CHECK_THROWS_AS(soci::session(backEnd, "dbname=:memory: bulk_batch_size=many"),
+                    soci_error);
+}
+
+// Aggregate used by the test below.
+struct weighted_average
+{
+    weighted_average() : sum_(0), weights_(0) {}
+
+    void step(double value, int weight)
+    {
+        sum_ += value * weight;
+        weights_ += weight;
+    }
+
+    double finalize() const
+    {
+        if (weights_ == 0)
+            throw std::runtime_error("no weights");
+
+        return sum_ / weights_;
+    }
+
+    double sum_;
+    int weights_;
+};
+
+TEST_CASE("SQLite user-defined functions", "[sqlite][function]")
+{
+    soci::session sql(backEnd, connectString);
+    table_creator_for_vector_into_strings tableCreator(sql);
+
+    sqlite3_session_backend* const sbe
+        = static_cast<sqlite3_session_backend*>(sql.get_backend());
+
+    sbe->create_function<std::string(std::string, int)>("repeat",
+        [](std::string const& s, int n)
+        {
+            std::string res;
+            for (int i = 0; i < n; ++i)
+                res += s;
+            return res;
+        });
+
+    int calls = 0;
+    sbe->create_function<long long(long long)>("count_calls",
+        [&calls](long long x) { ++calls; return x; }, false);
+
+    sbe->create_aggregate<double(double, int), weighted_average>("wavg");
+
+    for (int i = 1; i <= 4; ++i)
+    {
+        std::string const str(i, 'x');
+        sql << "insert into soci_test(val, str) values(:val, :str)",
+            use(i), use(str);
+    }
+
+    std::string s;
+    sql << "select repeat(str, val) from soci_test where val = 2", into(s);
+    CHECK(s == "xxxx");
+
+    // Functions can be used for filtering.
+    int count = 0;
+    sql << "select count(*) from soci_test where length(repeat(str, 2)) > 4",
+        into(count);
+    CHECK(count == 2);
+
+    long long sum = 0;
+    sql << "select sum(count_calls(val)) from soci_test", into(sum);
+    CHECK(sum == 10);
+    CHECK(calls == 4);
+
+    double avg = 0;
+    sql << "select wavg(val, val) from soci_test", into(avg);
+    CHECK(avg == Approx(3.0));
+
+    // Exceptions thrown by the functions are reported as SQL errors.
+    CHECK_THROWS_WITH(
+        (sql << "select wavg(val, 0) from soci_test", into(avg)),
+        Catch::Contains("no weights"));
+
+    // Even if they're not derived from std::exception.
+    sbe->create_function<int(int)>("throw_int",
+        [](int x) -> int { throw x; });
+    int n = 0;
+    CHECK_THROWS_WITH(
+        (sql << "select throw_int(val) from soci_test", into(n)),
+        Catch::Contains("unknown C++ exception"));
+
+    // Wrong number of arguments is detected by SQLite.
+    CHECK_THROWS_AS(
+        (sql << "select repeat(str) from soci_test", into(s)),
+        soci_error);
+
+    sbe->remove_function("repeat", 2);
+    CHECK_THROWS_AS(
+        (sql << "select repeat(str, 1) from soci_test", into(s)),
+        soci_error);
+}
+
+TEST_CASE("SQLite memory table", "[sqlite][memory-table]")
+{
+    soci::session sql(backEnd, connectString);
+    table_creator_for_vector_into_strings tableCreator(sql);
+
+    sqlite3_session_backend* const sbe
+        = static_cast<sqlite3_session_backend*>(sql.get_backend());
+
+    std::vector<int> ids;
+    std::vector<std::string> names;
+    std::vector<double> scores;
+    std::vector<indicator> scoreInds;
+    for (int i = 0; i != 5; ++i)
+    {
+        ids.push_back(i * 10);
+        names.push_back("name" + std::to_string(i));
+        scores.push_back(i / 2.);
+        scoreInds.push_back(i == 3 ? i_null : i_ok);
+    }
+
+    sbe->create_memory_table("lookup", sqlite3_memory_table()
+                                .add_column("id", ids)
+                                .add_column("name", names)
+                                .add_column("score", scores, &scoreInds));
+
+    for (int i = 0; i != 3; ++i)
+    {
+        int const val = i * 10;
+        sql << "insert into soci_test(val) values(:val)", use(val);
+    }
+
+    std::vector<std::string> joined(10);
+    sql << "select l.name from soci_test t join lookup l on l.id = t.val"
+           " order by t.val", into(joined);
+    REQUIRE(joined.size() == 3);
+    CHECK(joined[0] == "name0");
+    CHECK(joined[2] == "name2");
+
+    int count = 0;
+    sql << "select count(*) from lookup where score is null", into(count);
+    CHECK(count == 1);
+
+    // Row IDs are the indices in the vectors.
+    std::string name;
+    sql << "select name from lookup where rowid = 4", into(name);
+    CHECK(name == "name4");
+
+    indicator ind = i_ok;
+    sql << "select name from lookup where rowid = 5", into(name, ind);
+    CHECK(!sql.got_data());
+
+    // The changes to the vectors are taken into account.
+    ids.push_back(50);
+    names.push_back("name5");
+    scores.push_back(2.5);
+    scoreInds.push_back(i_ok);
+    sql << "select count(*) from lookup", into(count);
+    CHECK(count == 6);
+
+    // But their sizes must match.
+    names.pop_back();
+    CHECK_THROWS_WITH(
+        (sql << "select count(*) from lookup", into(count)),
+        Catch::Contains("size of column \"name\""));
+
+    sbe->drop_memory_table("lookup");
+    CHECK_THROWS_AS(
+        (sql << "select count(*) from lookup", into(count)),
+        soci_error);
+}
+
+TEST_CASE("SQLite statement cache", "[sqlite][statement-cache]")
+{
+    soci::session sql(backEnd, "dbname=:memory: statement_cache_size=2");
+    table_creator_for_vector_into_strings tableCreator(sql);
+
+    for (int i = 0; i != 10; ++i)
+    {
+        sql << "insert into soci_test(val) values(:val)", use(i);
+    }
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 10);
+
+    std::string const query = "select val from soci_test where val = :val";
+    sqlite_api::sqlite3_stmt* cached = NULL;
+    {
+        int val = 3, res = 0;
+        statement st = (sql.prepare << query, use(val), into(res));
+        st.execute(true);
+        CHECK(res == 3);
+
+        cached = static_cast<sqlite3_statement_backend*>(st.get_backend())->stmt_;
+    }
+
+    // The same statement should be reused for the same query.
+    {
+        int val = 5, res = 0;
+        statement st = (sql.prepare << query, use(val), into(res));
+        CHECK(static_cast<sqlite3_statement_backend*>(st.get_backend())->stmt_ == cached);
+        st.execute(true);
+        CHECK(res == 5);
+
+        // But not by another statement with the same query used concurrently.
+        int val2 = 7, res2 = 0;
+        statement st2 = (sql.prepare << query, use(val2), into(res2));
+        CHECK(static_cast<sqlite3_statement_backend*>(st2.get_backend())->stmt_ != cached);
+        st2.execute(true);
+        CHECK(res2 == 7);
+        CHECK(res == 5);
+    }
+
+    // Filling the cache with other statements evicts the old ones, but they
+    // still work.
+    for (int i = 0; i != 5; ++i)
+    {
+        std::ostringstream oss;
+        oss << "select val + " << i << " from soci_test where val = 1";
+        int res = 0;
+        sql << oss.str(), into(res);
+        CHECK(res == i + 1);
+    }
+
+    int const last = count - 1;
+    int res = 0;
+    sql << query, use(last), into(res);
+    CHECK(res == 9);
+
+    // Changing the schema doesn't prevent cached statements from working.
+    sql << "alter table soci_test add column extra integer";
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 10);
+
+    // Invalid cache sizes are rejected.
+    CHECK_THROWS_AS(soci::session(backEnd, "dbname=:memory: statement_cache_size=-1"),
+                    soci_error);
+    CHECK_THROWS_AS(soci::session(backEnd, "dbname=:memory: statement_cache_size=abc"),
+                    soci_error);
+    CHECK_THROWS_AS(soci::session(backEnd, "dbname=:memory: statement_cache_size=10x"),
+                    soci_error);
+}
+
+// Database file in the temporary directory with a name unique to this
+// process, so that several test programs can run concurrently, removed
+// together with the auxiliary SQLite files when it goes out of scope.
+class temp_db_file
+{
+public:
+    explicit temp_db_file(char const* name)
+    {
+#ifdef _WIN32
+        char const* dir = std::getenv("TEMP");
+        char const sep = '\\';
+        int const pid = _getpid();
+#else
+        char const* dir = std::getenv("TMPDIR");
+        if (dir == NULL || *dir == '\0')
+            dir = "/tmp";
+        char const sep = '/';
+        int const pid = static_cast<int>(getpid());
+#endif
+
+        std::ostringstream oss;
+        if (dir != NULL && *dir != '\0')
+            oss << dir << sep;
+        oss << name << '-' << pid << ".db";
+        path_ = oss.str();
+
+        remove_all();
+    }
+
+    ~temp_db_file()
+    {
+        remove_all();
+    }
+
+    char const* c_str() const { return path_.c_str(); }
+
+private:
+    void remove_all() const
+    {
+        std::remove(path_.c_str());
+        std::remove((path_ + "-journal").c_str());
+        std::remove((path_ + "-wal").c_str());
+        std::remove((path_ + "-shm").c_str());
+    }
+
+    std::string path_;
+
+    SOCI_NOT_COPYABLE(temp_db_file)
+};
+
+TEST_CASE("SQLite WAL pool", "[sqlite][pool]")
+{
+    // WAL mode can't be used with in-memory databases.
+    CHECK_THROWS_AS(sqlite3_wal_pool(":memory:", 2), soci_error);
+
+    temp_db_file const dbfile("soci_test_wal_pool");
+    char const* const dbname = dbfile.c_str();
+
+    {
+        sqlite3_wal_pool pool(dbname, 2, 1024*1024);
+
+        {
+            session sql(pool.for_write());
+            sql << "create table soci_test(val integer)";
+            sql << "insert into soci_test(val) values(17)";
+        }
+
+        // Both readers can be used at the same time, even while a write
+        // transaction is in progress.
+        session writer(pool.get(true));
+        transaction tr(writer);
+        writer << "insert into soci_test(val) values(18)";
+
+        session reader1(pool.for_read());
+        session reader2(pool.get(false));
+
+        int count1 = 0, count2 = 0;
+        reader1 << "select count(*) from soci_test", into(count1);
+        reader2 << "select count(*) from soci_test", into(count2);
+        CHECK(count1 == 1);
+        CHECK(count2 == 1);
+
+        tr.commit();
+
+        reader1 << "select count(*) from soci_test", into(count1);
+        CHECK(count1 == 2);
+
+        // And the readers really are read-only.
+        CHECK_THROWS_AS(reader2 << "delete from soci_test", soci_error);
+    }
+}
+
+TEST_CASE("SQLite in-memory copy of database file", "[sqlite][backup]")
+{
+    temp_db_file const dbfile("soci_test_backup");
+    char const* const dbname = dbfile.c_str();
+
+    {
+        soci::session sql(backEnd, dbname);
+        sql << "create table soci_test(val integer)";
+        sql << "insert into soci_test(val) values(17)";
+    }
+
+    {
+        soci::session sql(backEnd,
+                          std::string("db=\"") + dbname + "\" in_memory=true");
+
+        int val = 0;
+        sql << "select val from soci_test", into(val);
+        CHECK(val == 17);
+
+        // Changes are done in memory only.
+        sql << "insert into soci_test(val) values(18)";
+
+        int count = 0;
+        {
+            soci::session sqlFile(backEnd, dbname);
+            sqlFile << "select count(*) from soci_test", into(count);
+            CHECK(count == 1);
+        }
+
+        // Until they're explicitly saved.
+        sqlite3_session_backend* const sbe
+            = static_cast<sqlite3_session_backend*>(sql.get_backend());
+        sbe->save_to(dbname);
+
+        {
+            soci::session sqlFile(backEnd, dbname);
+            sqlFile << "select count(*) from soci_test", into(count);
+            CHECK(count == 2);
+        }
+
+        // Loading replaces the existing contents.
+        soci::session sqlOther(backEnd, ":memory:");
+        sqlite3_session_backend* const sbeOther
+            = static_cast<sqlite3_session_backend*>(sqlOther.get_backend());
+        sbeOther->load_from(dbname);
+        sqlOther << "select count(*) from soci_test", into(count);
+        CHECK(count == 2);
+    }
+
+    // With in_memory=save the changes are saved when closing the session.
+    {
+        soci::session sql(backEnd,
+                          std::string("db=\"") + dbname + "\" in_memory=save");
+        sql << "insert into soci_test(val) values(19)";
+
+        int count = 0;
+        {
+            soci::session sqlFile(backEnd, dbname);
+            sqlFile << "select count(*) from soci_test", into(count);
+            CHECK(count == 2);
+        }
+    }
+
+    {
+        int count = 0;
+        soci::session sqlFile(backEnd, dbname);
+        sqlFile << "select count(*) from soci_test", into(count);
+        CHECK(count == 3);
+    }
+
+    CHECK_THROWS_AS(
+        soci::session(backEnd, "db=soci_test_no_such.db nocreate=1 in_memory=true"),
+        soci_error);
+    CHECK_THROWS_AS(
+        soci::session(backEnd, std::string("db=\"") + dbname + "\" in_memory=maybe"),
+        soci_error);
+}
+
 // DDL Creation objects for common tests
 struct table_creator_one : public table_creator_base
 {